@@ -0,0 +1,180 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <memory_resource>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+using namespace std;
+
+/**
+ * @class BatchArena
+ * @brief Memória de um batch: alocação por incremento de ponteiro, liberada toda de uma vez.
+ *
+ * As colunas criadas com uma arena (ver Column) alocam seus buffers nela; deallocate não faz
+ * nada e a memória volta inteira quando o último DataFrame que usa a arena é destruído e
+ * ela é devolvida ao ArenaPool. reset() mantém os blocos já obtidos do sistema, de modo que,
+ * depois dos primeiros batches, montar um batch não chama malloc/free.
+ *
+ * Não é thread-safe: só o extrator que monta o batch aloca nela. Ao entregar o batch ele lacra
+ * as colunas (Column::lacraArena), e as alterações feitas depois pelas etapas vão para o heap.
+ */
+class BatchArena : public pmr::memory_resource
+{
+private:
+    struct Bloco
+    {
+        unique_ptr<byte[]> dados;
+        size_t tamanho;
+    };
+
+    static constexpr size_t kTamanhoInicial = 64 * 1024;
+
+    vector<Bloco> vBlocos; ///< Blocos obtidos do sistema
+    size_t iBlocoAtual = 0; ///< Bloco em que as alocações estão sendo feitas
+    size_t iUsado = 0;      ///< Bytes usados do bloco atual
+
+    void novoBloco(size_t iMinimo)
+    {
+        size_t tamanho = vBlocos.empty() ? kTamanhoInicial : vBlocos.back().tamanho * 2;
+        while (tamanho < iMinimo)
+            tamanho *= 2;
+        vBlocos.push_back(Bloco{unique_ptr<byte[]>(new byte[tamanho]), tamanho});
+    }
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        while (true)
+        {
+            if (iBlocoAtual < vBlocos.size())
+            {
+                Bloco &bloco = vBlocos[iBlocoAtual];
+                uintptr_t base = reinterpret_cast<uintptr_t>(bloco.dados.get());
+                uintptr_t inicio = (base + iUsado + alignment - 1) & ~(uintptr_t(alignment) - 1);
+                if (inicio + bytes <= base + bloco.tamanho)
+                {
+                    iUsado = inicio + bytes - base;
+                    return reinterpret_cast<void *>(inicio);
+                }
+                // Passa para o próximo bloco já existente (se houver) ou cria um maior
+                iBlocoAtual++;
+                iUsado = 0;
+                continue;
+            }
+            novoBloco(bytes + alignment);
+        }
+    }
+
+    void do_deallocate(void *, size_t, size_t) override {}
+
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+public:
+    BatchArena() = default;
+    BatchArena(const BatchArena &) = delete;
+    BatchArena &operator=(const BatchArena &) = delete;
+
+    /**
+     * @brief Descarta todas as alocações, mantendo a memória para o próximo batch.
+     *
+     * Se o batch anterior precisou de mais de um bloco, eles são trocados por um único
+     * bloco com a soma dos tamanhos, para que o próximo caiba sem trocar de bloco.
+     */
+    void reset()
+    {
+        if (vBlocos.size() > 1)
+        {
+            size_t total = 0;
+            for (const auto &bloco : vBlocos)
+                total += bloco.tamanho;
+            vBlocos.clear();
+            vBlocos.push_back(Bloco{unique_ptr<byte[]>(new byte[total]), total});
+        }
+        iBlocoAtual = 0;
+        iUsado = 0;
+    }
+
+    /**
+     * @brief Retorna o total de bytes obtidos do sistema.
+     */
+    size_t capacidade() const
+    {
+        size_t total = 0;
+        for (const auto &bloco : vBlocos)
+            total += bloco.tamanho;
+        return total;
+    }
+};
+
+/**
+ * @class ArenaPool
+ * @brief Reaproveita as arenas dos batches que já foram consumidos.
+ *
+ * acquire() devolve uma arena em um shared_ptr cujo destrutor a reinicia e a devolve ao
+ * pool, de modo que a arena volta a ser usada assim que a última coluna que a referencia é
+ * destruída, em qualquer thread. O pool é criado pelo Manager e compartilhado com os extratores.
+ */
+class ArenaPool : public enable_shared_from_this<ArenaPool>
+{
+private:
+    mutex mtx;
+    vector<unique_ptr<BatchArena>> vLivres; ///< Arenas prontas para reuso
+    size_t iMaxLivres;                      ///< Máximo de arenas guardadas
+
+    void devolve(BatchArena *pArena)
+    {
+        unique_ptr<BatchArena> arena(pArena);
+        arena->reset();
+        lock_guard<mutex> lock(mtx);
+        if (vLivres.size() < iMaxLivres)
+            vLivres.push_back(std::move(arena));
+    }
+
+public:
+    /**
+     * @param iMaxLivres Número máximo de arenas livres guardadas (as demais são liberadas).
+     */
+    explicit ArenaPool(size_t iMaxLivres = 64) : iMaxLivres(iMaxLivres) {}
+
+    /**
+     * @brief Retorna uma arena livre (ou uma nova), devolvida ao pool quando não for mais usada.
+     */
+    shared_ptr<BatchArena> acquire()
+    {
+        unique_ptr<BatchArena> arena;
+        {
+            lock_guard<mutex> lock(mtx);
+            if (!vLivres.empty())
+            {
+                arena = std::move(vLivres.back());
+                vLivres.pop_back();
+            }
+        }
+        if (!arena)
+            arena = make_unique<BatchArena>();
+
+        weak_ptr<ArenaPool> pPool = weak_from_this();
+        return shared_ptr<BatchArena>(arena.release(), [pPool](BatchArena *pArena)
+                                      {
+            if (auto pool = pPool.lock())
+                pool->devolve(pArena);
+            else
+                delete pArena; });
+    }
+
+    /**
+     * @brief Retorna o número de arenas livres no pool.
+     */
+    size_t livres()
+    {
+        lock_guard<mutex> lock(mtx);
+        return vLivres.size();
+    }
+};
+
+#endif // ARENA_H
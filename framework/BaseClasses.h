@@ -4,6 +4,11 @@
 #include "Buffer.h"
 #include "Dataframe.h"
 #include "TaskQueue.h"
+#include "CsvTokenizer.h"
+#include "MappedFile.h"
+#include "StringInterner.h"
+#include "Arena.h"
+#include "Scheduler.h"
 #include <utility> // Para std::forward
 #include <tuple>
 #include <optional>
@@ -11,21 +16,86 @@
 #include <sqlite3.h>
 #include <string>
 #include <vector>
+#include <memory>
 #include <fstream>
 #include <map>
 #include <regex>
 #include <sstream>
 #include <any>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
 #include "Series.h"
 #include <any>
 
 using namespace std;
 
+/**
+ * @brief Filtro simples aplicado durante a extração (coluna = valor ou coluna entre dois limites).
+ *
+ * No CSV o filtro é testado no texto do campo; no SQLite ele vira uma condição do WHERE.
+ */
+struct FiltroExtracao
+{
+    size_t iColuna = 0;      ///< Índice da coluna no cabeçalho
+    bool bIntervalo = false; ///< true: dMinimo <= valor <= dMaximo; false: igualdade
+    bool bNumerico = false;  ///< Igualdade numérica (dValor) ou textual (strValor)
+    bool bInteiro = false;   ///< Valor da igualdade numérica é inteiro (iValor)
+    int64_t iValor = 0;
+    double dValor = 0.0;
+    string strValor;
+    double dMinimo = 0.0;
+    double dMaximo = 0.0;
+
+    /**
+     * @brief Testa o filtro no texto de um campo.
+     * @param campo Texto do campo.
+     * @return true se a linha deve ser mantida.
+     */
+    bool bAceita(string_view campo) const
+    {
+        if (!bIntervalo && !bNumerico)
+            return campo == strValor;
+        double d;
+        auto [fim, erro] = from_chars(campo.data(), campo.data() + campo.size(), d);
+        if (erro != errc() || fim != campo.data() + campo.size())
+            return false;
+        if (bIntervalo)
+            return d >= dMinimo && d <= dMaximo;
+        return d == dValor;
+    }
+
+    /**
+     * @brief Vincula os valores do filtro aos parâmetros de uma consulta SQLite.
+     * @param stmt Consulta preparada.
+     * @param iParametro Índice do primeiro parâmetro do filtro.
+     * @return Índice do próximo parâmetro livre.
+     */
+    int iVincula(sqlite3_stmt *stmt, int iParametro) const
+    {
+        if (bIntervalo)
+        {
+            sqlite3_bind_double(stmt, iParametro++, dMinimo);
+            sqlite3_bind_double(stmt, iParametro++, dMaximo);
+        }
+        else if (bNumerico && bInteiro)
+            sqlite3_bind_int64(stmt, iParametro++, iValor);
+        else if (bNumerico)
+            sqlite3_bind_double(stmt, iParametro++, dValor);
+        else
+            sqlite3_bind_text(stmt, iParametro++, strValor.c_str(), static_cast<int>(strValor.size()), SQLITE_TRANSIENT);
+        return iParametro;
+    }
+};
+
 /**
  * @brief Classe base para extratores de dados.
  */
 template <typename T>
-class Extrator
+class Extrator : public Stage
 {
 protected:
     vector<string> strColumnsName;
@@ -36,8 +106,87 @@ protected:
     ifstream file;
     sqlite3 *bancoDeDados;
     string strNomeTabela;
+    // Caminho do banco e conexões somente leitura de cada thread (quando flag == "sql")
+    string strCaminhoBanco;
+    unordered_map<thread::id, sqlite3 *> umapConexoes;
+    mutex mtxConexoes;
     // Dados CSV em memória (quando flag == "memo")
     string memoData;
+    // Arquivo CSV mapeado em memória (quando flag == "mmap")
+    MappedFile arquivoMapeado;
+    // Se true, textos em memória ("memo" e "mmap") são particionados de uma vez entre as threads
+    bool bParallelScan = false;
+    // Colunas de strings codificadas por dicionário e o dicionário compartilhado pelos batches
+    vector<string> vstrColunasDicionario;
+    shared_ptr<StringInterner> pDicionario = make_shared<StringInterner>();
+    // Pool de arenas dos batches extraídos (definido pelo Manager; nulo: heap)
+    shared_ptr<ArenaPool> pPoolArenas;
+    // Tipo de cada coluna, na ordem de strColumnsName (vazio: todas "string")
+    vector<string> vstrTiposColunas;
+    // Linhas descartadas por terem algum valor que não é do tipo da coluna no schema
+    atomic<size_t> iLinhasForaDoSchema{0};
+    // Tipos declarados na tabela SQL (PRAGMA table_info), na ordem de strColumnsName
+    vector<string> vstrTiposDeclarados;
+    // Colunas a materializar (vazio: todas) e filtros aplicados durante a extração
+    vector<string> vstrProjecao;
+    vector<FiltroExtracao> vFiltros;
+
+    // Estado da geração incremental das tarefas (ver bProximaTarefa)
+    bool bGeracaoIniciada = false;
+    bool bGeracaoConcluida = false;
+    istream *pEntradaLinhas = nullptr; // "csv" e "memo" sequencial: linhas ainda não lidas
+    istringstream ssMemo;
+    int64_t iProximo = 0;              // Próximo rowid ("sql")
+    int64_t iUltimo = -1;              // Último rowid ("sql")
+    long double dDensidadeRowid = 1.0L; // Rowids por linha da tabela ("sql")
+    bool bTabelaInteira = false;       // "sql" sem rowid: uma única tarefa
+    string_view svConteudo;            // Texto dividido em blocos ("mmap" e "memo" paralelo)
+    size_t iByteProximo = 0;           // Início do próximo bloco em svConteudo
+    size_t iBytesPorLinha = 1;         // Tamanho médio estimado de uma linha de svConteudo
+    bool bAlinhaNaEtapa = false;       // Blocos alinhados pela etapa, respeitando aspas
+
+    // Ajuste adaptativo do tamanho do batch (ver setAdaptiveBatchSize)
+    bool bBatchAdaptativo = false;
+    double dLatenciaAlvoMs = 0.0;
+    int iBatchMinimo = 1;
+    int iBatchMaximo = 1;
+    double dNsPorLinha = 0.0; // Custo médio estimado de extração de uma linha (0: ainda não medido)
+    mutex mtxMedidas;
+    int64_t iNsMedidos = 0;     // Tempo das tarefas terminadas desde o último ajuste
+    int64_t iLinhasMedidas = 0; // Tamanho de batch somado dessas tarefas
+
+    /**
+     * @brief Retorna o índice de uma coluna no cabeçalho.
+     * @throw invalid_argument Se a coluna não existir.
+     */
+    size_t iIndiceColuna(const string &strColuna) const
+    {
+        auto it = find(this->strColumnsName.begin(), this->strColumnsName.end(), strColuna);
+        if (it == this->strColumnsName.end())
+        {
+            throw invalid_argument("Coluna '" + strColuna + "' não encontrada.");
+        }
+        return distance(this->strColumnsName.begin(), it);
+    }
+
+    /**
+     * @brief Retorna os índices, no cabeçalho, das colunas que vão para os DataFrames extraídos.
+     */
+    vector<size_t> viColunasSaida() const
+    {
+        vector<size_t> viSaida;
+        if (this->vstrProjecao.empty())
+        {
+            for (size_t j = 0; j < this->strColumnsName.size(); j++)
+                viSaida.push_back(j);
+        }
+        else
+        {
+            for (const auto &strColuna : this->vstrProjecao)
+                viSaida.push_back(iIndiceColuna(strColuna));
+        }
+        return viSaida;
+    }
 
 public:
     /**
@@ -64,6 +213,7 @@ public:
 
         else if (this->strFilesFlag == "sql")
         {
+            this->strCaminhoBanco = strFilesPath;
             int exit = sqlite3_open(strFilesPath.c_str(), &this->bancoDeDados);
             if (exit)
             {
@@ -74,21 +224,29 @@ public:
                 lerCabecalhoSQL(this->strNomeTabela);
             }
         }
+        else if (this->strFilesFlag == "mmap")
+        {
+            // Arquivo CSV mapeado em memória; as tarefas recebem views do mapeamento
+            this->arquivoMapeado = MappedFile(strFilesPath);
+            string_view conteudo = this->arquivoMapeado.view();
+            if (!conteudo.empty())
+            {
+                strColumnsName = CsvTokenizer::splitLinha(conteudo.substr(0, conteudo.find('\n')));
+            }
+            else
+            {
+                cerr << "Erro ao ler o cabeçalho do CSV." << endl;
+            }
+        }
         else if (this->strFilesFlag == "memo")
         {
             // Dados CSV já carregados em memória
             this->memoData = strFilesPath;
             // Ler cabeçalho da string CSV em memória
-            stringstream ss(memoData);
-            string line;
-            if (getline(ss, line))
+            size_t fimCabecalho = memoData.find('\n');
+            if (!memoData.empty())
             {
-                stringstream hss(line);
-                string cell;
-                while (getline(hss, cell, ','))
-                {
-                    strColumnsName.push_back(cell);
-                }
+                strColumnsName = CsvTokenizer::splitLinha(string_view(memoData).substr(0, fimCabecalho));
             }
             else
             {
@@ -115,6 +273,10 @@ public:
             {
                 sqlite3_close(this->bancoDeDados);
             }
+            for (auto &[id, conexao] : this->umapConexoes)
+            {
+                sqlite3_close(conexao);
+            }
         }
     };
 
@@ -137,7 +299,7 @@ public:
     Buffer<T> &get_output_buffer() { return outputBuffer; }
 
     /**
-     * @brief Retorna a flag dos arquivos (csv ou sql).
+     * @brief Retorna a flag dos arquivos (csv, mmap, sql ou memo).
      * @return String representando o tipo de arquivo.
      */
     string getFilesFlag() const { return this->strFilesFlag; }
@@ -166,6 +328,304 @@ public:
      */
     void setBatchSize(int iTamanhoBatch) { this->iTamanhoBatch = iTamanhoBatch; }
 
+    /**
+     * @brief Ativa o ajuste automático do tamanho do batch durante a extração.
+     *
+     * O tamanho passado ao construtor (ou a setBatchSize) é o ponto de partida. Antes de
+     * criar cada tarefa, o extrator estima o custo por linha a partir do tempo medido nas
+     * tarefas já concluídas e escolhe o batch que levaria dLatenciaAlvoMs para ser extraído.
+     * Se o buffer de saída está ocupado, as etapas seguintes estão atrasadas e o batch é
+     * reduzido (até a metade com o buffer cheio), para que cada batch chegue antes ao fim do
+     * pipeline. A cada ajuste o tamanho no máximo dobra ou cai pela metade.
+     * @param dLatenciaAlvoMs Tempo alvo de extração de um batch, em milissegundos (<= 0 desativa).
+     * @param iMinimo Menor tamanho de batch permitido.
+     * @param iMaximo Maior tamanho de batch permitido.
+     */
+    void setAdaptiveBatchSize(double dLatenciaAlvoMs, int iMinimo = 100, int iMaximo = 1000000)
+    {
+        this->bBatchAdaptativo = dLatenciaAlvoMs > 0;
+        this->dLatenciaAlvoMs = dLatenciaAlvoMs;
+        this->iBatchMinimo = max(iMinimo, 1);
+        this->iBatchMaximo = max(iMaximo, this->iBatchMinimo);
+    }
+
+    /**
+     * @brief Retorna se o ajuste automático do tamanho do batch está ativo.
+     */
+    bool getAdaptiveBatchSize() const { return this->bBatchAdaptativo; }
+
+    /**
+     * @brief Ativa a leitura particionada em paralelo para os modos "memo" e "mmap".
+     * @param bParallelScan Se true, todas as tarefas são criadas de uma vez e cada uma alinha o próprio intervalo.
+     */
+    void setParallelScan(bool bParallelScan) { this->bParallelScan = bParallelScan; }
+
+    /**
+     * @brief Retorna se a leitura particionada em paralelo está ativa.
+     */
+    bool getParallelScan() const { return this->bParallelScan; }
+
+    /**
+     * @brief Define as colunas que serão codificadas por dicionário (códigos uint32_t).
+     *
+     * Indicado para colunas com poucos valores distintos, como chaves de agrupamento e de join.
+     * @param vstrColunas Nomes das colunas.
+     */
+    void setDictionaryColumns(const vector<string> &vstrColunas) { this->vstrColunasDicionario = vstrColunas; }
+
+    /**
+     * @brief Define o dicionário usado pelas colunas codificadas.
+     *
+     * Extratores cujas saídas serão comparadas entre si (por exemplo, os dois lados de um
+     * join) devem compartilhar o mesmo dicionário para que os códigos sejam comparáveis.
+     * @param pDicionario Dicionário compartilhado.
+     */
+    void setStringInterner(shared_ptr<StringInterner> pDicionario) { this->pDicionario = std::move(pDicionario); }
+
+    /**
+     * @brief Retorna o dicionário usado pelas colunas codificadas.
+     */
+    shared_ptr<StringInterner> getStringInterner() const { return this->pDicionario; }
+
+    /**
+     * @brief Define o pool de arenas de onde saem os buffers das colunas de cada batch.
+     *
+     * Chamado pelo Manager. Sem pool, as colunas são alocadas no heap.
+     * @param pPool Pool compartilhado pelos extratores do pipeline.
+     */
+    void setArenaPool(shared_ptr<ArenaPool> pPool) { this->pPoolArenas = std::move(pPool); }
+
+    /**
+     * @brief Define o tipo de algumas colunas; os campos passam a ser lidos direto nesse tipo.
+     *
+     * Colunas não informadas continuam "string". Linhas com campos que não podem ser
+     * lidos no tipo da coluna são descartadas com um erro em cerr (ver getLinhasForaDoSchema).
+     * @param mapTipos Nome da coluna -> tipo ("int", "double", "bool" ou "string").
+     * @throw invalid_argument Se alguma coluna não existir ou algum tipo for inválido.
+     */
+    void setSchema(const map<string, string> &mapTipos)
+    {
+        vector<string> vstrTipos(this->strColumnsName.size(), "string");
+        for (const auto &[strColuna, strTipo] : mapTipos)
+        {
+            auto it = find(this->strColumnsName.begin(), this->strColumnsName.end(), strColuna);
+            if (it == this->strColumnsName.end())
+            {
+                throw invalid_argument("Coluna '" + strColuna + "' não encontrada.");
+            }
+            if (strTipo != "int" && strTipo != "double" && strTipo != "bool" && strTipo != "string")
+            {
+                throw invalid_argument("Tipo inválido: " + strTipo);
+            }
+            vstrTipos[distance(this->strColumnsName.begin(), it)] = strTipo;
+        }
+        this->vstrTiposColunas = vstrTipos;
+    }
+
+    /**
+     * @brief Retorna o tipo de cada coluna extraída, na ordem de getColumnsName().
+     */
+    vector<string> getSchema() const
+    {
+        if (this->vstrTiposColunas.empty())
+        {
+            return vector<string>(this->strColumnsName.size(), "string");
+        }
+        return this->vstrTiposColunas;
+    }
+
+    /**
+     * @brief Retorna quantas linhas foram descartadas por terem um valor que não é do tipo da coluna.
+     *
+     * Com inferSchema, basta um valor fora da amostra que não caiba no tipo inferido (ex.: um
+     * real numa coluna inferida como int) para a linha ser descartada. Os tipos não são
+     * alargados durante a extração, pois os batches já enviados ficariam com outro tipo.
+     */
+    size_t getLinhasForaDoSchema() const { return this->iLinhasForaDoSchema.load(); }
+
+    /**
+     * @brief Restringe os DataFrames extraídos às colunas informadas (na ordem dada).
+     *
+     * No SQLite só essas colunas entram no SELECT; no CSV as demais são apenas percorridas
+     * pelo tokenizador, sem serem copiadas.
+     * @param vstrColunas Nomes das colunas (vazio: todas).
+     * @throw invalid_argument Se alguma coluna não existir.
+     */
+    void setProjection(const vector<string> &vstrColunas)
+    {
+        for (const auto &strColuna : vstrColunas)
+        {
+            iIndiceColuna(strColuna);
+        }
+        this->vstrProjecao = vstrColunas;
+    }
+
+    /**
+     * @brief Retorna se uma projeção foi definida.
+     */
+    bool hasProjection() const { return !this->vstrProjecao.empty(); }
+
+    /**
+     * @brief Retorna as colunas dos DataFrames extraídos.
+     */
+    vector<string> getProjection() const
+    {
+        vector<string> vstrColunas;
+        for (size_t j : viColunasSaida())
+        {
+            vstrColunas.push_back(this->strColumnsName[j]);
+        }
+        return vstrColunas;
+    }
+
+    /**
+     * @brief Mantém apenas as linhas em que a coluna é igual ao valor (a coluna não precisa estar na projeção).
+     *
+     * Valores int, int64_t ou double são comparados numericamente; os demais, como texto.
+     * @param strColuna Nome da coluna.
+     * @param valor Valor procurado.
+     * @throw invalid_argument Se a coluna não existir.
+     */
+    void addEqualityFilter(const string &strColuna, const any &valor)
+    {
+        FiltroExtracao filtro;
+        filtro.iColuna = iIndiceColuna(strColuna);
+        const type_info &tipo = valor.type();
+        if (tipo == typeid(int) || tipo == typeid(int64_t))
+        {
+            filtro.bNumerico = filtro.bInteiro = true;
+            filtro.iValor = tipo == typeid(int) ? any_cast<int>(valor) : any_cast<int64_t>(valor);
+            filtro.dValor = static_cast<double>(filtro.iValor);
+        }
+        else if (tipo == typeid(double))
+        {
+            filtro.bNumerico = true;
+            filtro.dValor = any_cast<double>(valor);
+        }
+        else
+        {
+            filtro.strValor = anyToString(valor);
+        }
+        this->vFiltros.push_back(filtro);
+    }
+
+    /**
+     * @brief Mantém apenas as linhas em que a coluna (numérica) está entre dMinimo e dMaximo, inclusive.
+     * @param strColuna Nome da coluna.
+     * @param dMinimo Limite inferior.
+     * @param dMaximo Limite superior.
+     * @throw invalid_argument Se a coluna não existir.
+     */
+    void addRangeFilter(const string &strColuna, double dMinimo, double dMaximo)
+    {
+        FiltroExtracao filtro;
+        filtro.iColuna = iIndiceColuna(strColuna);
+        filtro.bIntervalo = true;
+        filtro.dMinimo = dMinimo;
+        filtro.dMaximo = dMaximo;
+        this->vFiltros.push_back(filtro);
+    }
+
+    /**
+     * @brief Remove os filtros de extração.
+     */
+    void clearFilters() { this->vFiltros.clear(); }
+
+    /**
+     * @brief Converte um tipo declarado no SQLite para um tipo de coluna (regras de afinidade).
+     * @param strDeclarado Tipo declarado na tabela (ex.: "INTEGER", "REAL", "TEXT").
+     */
+    static string strTipoSQL(string strDeclarado)
+    {
+        transform(strDeclarado.begin(), strDeclarado.end(), strDeclarado.begin(), ::toupper);
+        if (strDeclarado.find("INT") != string::npos)
+            return "int";
+        if (strDeclarado.find("CHAR") != string::npos || strDeclarado.find("CLOB") != string::npos ||
+            strDeclarado.find("TEXT") != string::npos)
+            return "string";
+        if (strDeclarado.find("BOOL") != string::npos)
+            return "bool";
+        if (strDeclarado.find("REAL") != string::npos || strDeclarado.find("FLOA") != string::npos ||
+            strDeclarado.find("DOUB") != string::npos || strDeclarado.find("NUMERIC") != string::npos ||
+            strDeclarado.find("DECIMAL") != string::npos)
+            return "double";
+        return "string";
+    }
+
+    /**
+     * @brief Infere o tipo das colunas e passa a ler os campos direto nesses tipos.
+     *
+     * No modo "sql" usa os tipos declarados na tabela (PRAGMA table_info). Nos demais,
+     * percorre as primeiras linhas do texto e escolhe, para cada coluna, o tipo mais
+     * restrito que aceita todos os valores da amostra (int, depois double, bool ou string).
+     * Linhas depois da amostra com valores fora desses tipos são descartadas com um erro em
+     * cerr (ver getLinhasForaDoSchema); se isso for possível, use uma amostra maior ou setSchema.
+     * @param iLinhasAmostra Número de linhas lidas para a inferência.
+     */
+    void inferSchema(size_t iLinhasAmostra = 1000)
+    {
+        size_t numColunas = this->strColumnsName.size();
+        if (this->strFilesFlag == "sql")
+        {
+            vector<string> vstrTipos(numColunas, "string");
+            for (size_t j = 0; j < numColunas && j < this->vstrTiposDeclarados.size(); j++)
+            {
+                vstrTipos[j] = strTipoSQL(this->vstrTiposDeclarados[j]);
+            }
+            this->vstrTiposColunas = vstrTipos;
+            return;
+        }
+
+        // Monta a amostra com as primeiras linhas (sem o cabeçalho)
+        string strCopia;
+        string_view amostra;
+        if (this->strFilesFlag == "csv")
+        {
+            streampos posicao = this->file.tellg();
+            string line;
+            for (size_t k = 0; k < iLinhasAmostra && getline(this->file, line); k++)
+            {
+                strCopia += line + "\n";
+            }
+            this->file.clear();
+            this->file.seekg(posicao);
+            amostra = strCopia;
+        }
+        else
+        {
+            amostra = this->strFilesFlag == "mmap" ? this->arquivoMapeado.view() : string_view(this->memoData);
+            size_t fimCabecalho = amostra.find('\n');
+            amostra.remove_prefix(fimCabecalho == string_view::npos ? amostra.size() : fimCabecalho + 1);
+            size_t fim = 0;
+            for (size_t k = 0; k < iLinhasAmostra && fim < amostra.size(); k++)
+            {
+                size_t quebra = amostra.find('\n', fim);
+                fim = quebra == string_view::npos ? amostra.size() : quebra + 1;
+            }
+            amostra = amostra.substr(0, fim);
+        }
+
+        vector<string> vstrTipos(numColunas);
+        CsvTokenizer tokenizer;
+        tokenizer.parse(amostra, [&](const vector<string_view> &campos)
+                        {
+            if (campos.size() != numColunas)
+                return;
+            for (size_t j = 0; j < numColunas; j++)
+            {
+                if (!campos[j].empty())
+                    vstrTipos[j] = Column::strUneTipos(vstrTipos[j], Column::strInfereTipo(campos[j]));
+            } });
+
+        // Colunas sem nenhum valor na amostra ficam como string
+        for (auto &strTipo : vstrTipos)
+        {
+            if (strTipo.empty())
+                strTipo = "string";
+        }
+        this->vstrTiposColunas = vstrTipos;
+    }
+
     /**
      * @brief Lê o cabeçalho de um arquivo CSV e popula o vetor de nomes de colunas.
      */
@@ -174,13 +634,7 @@ public:
         string line;
         if (getline(this->file, line))
         {
-            stringstream ss(line);
-            string cell;
-
-            while (getline(ss, cell, ','))
-            {
-                strColumnsName.push_back(cell);
-            }
+            strColumnsName = CsvTokenizer::splitLinha(line);
         }
         else
         {
@@ -197,12 +651,15 @@ public:
         string sql = "PRAGMA table_info(" + strNomeTabela + ");";
         sqlite3_stmt *stmt;
         this->strColumnsName.clear();
+        this->vstrTiposDeclarados.clear();
 
         if (sqlite3_prepare_v2(this->bancoDeDados, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
         {
             while (sqlite3_step(stmt) == SQLITE_ROW)
             {
                 this->strColumnsName.push_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
+                const unsigned char *tipo = sqlite3_column_text(stmt, 2);
+                this->vstrTiposDeclarados.push_back(tipo ? reinterpret_cast<const char *>(tipo) : "");
             }
             sqlite3_finalize(stmt);
         }
@@ -213,120 +670,260 @@ public:
     }
 
     /**
-     * @brief Enfileira as tarefas de extração dos dados conforme o tipo de arquivo.
+     * @brief Estima o tamanho médio de uma linha a partir do início do texto.
+     * @param strTexto Texto CSV (sem cabeçalho).
+     * @return Número médio de bytes por linha (pelo menos 1).
      */
-    void enqueue_tasks()
+    static size_t iEstimaBytesPorLinha(string_view strTexto)
     {
-        string strBlocoDeTexto;
-        int iContador = 0;
+        string_view amostra = strTexto.substr(0, 1 << 16);
+        size_t iLinhas = count(amostra.begin(), amostra.end(), '\n');
+        return max<size_t>(1, amostra.size() / max<size_t>(iLinhas, 1));
+    }
 
+    /**
+     * @brief Prepara a varredura paralela de um texto CSV já em memória (sem cabeçalho).
+     *
+     * O texto é dividido em intervalos de bytes com ~iTamanhoBatch linhas (pelo tamanho médio
+     * estimado de uma linha), e cada tarefa alinha o próprio intervalo em '\n' antes de
+     * processá-lo. Assim a etapa não percorre o texto, e tanto o alinhamento quanto o parsing
+     * são feitos pelas threads da pool. Os intervalos são criados um a um (ver bProximaTarefa),
+     * com o tamanho de batch atual.
+     *
+     * Uma tarefa não sabe se o início do seu intervalo está dentro de um campo entre aspas.
+     * Por isso, se algum campo entre aspas contém '\n' (e no "mmap" sequencial), a própria
+     * etapa alinha os blocos com MappedFile::fronteiraDeRegistro, que acompanha as aspas.
+     * @param conteudo Texto a ser particionado (deve permanecer válido até o fim das tarefas).
+     */
+    void iniciaVarreduraParalela(string_view conteudo)
+    {
+        this->svConteudo = conteudo;
+        this->iByteProximo = 0;
+        this->iBytesPorLinha = iEstimaBytesPorLinha(conteudo);
+        this->bAlinhaNaEtapa = !this->bParallelScan || MappedFile::temQuebraEntreAspas(conteudo);
+    }
+
+    /**
+     * @brief Prepara a geração das tarefas conforme o tipo de arquivo.
+     */
+    void iniciaGeracao()
+    {
         if (this->strFilesFlag == "csv")
         {
-            string line;
-            while (getline(file, line))
+            this->pEntradaLinhas = &this->file;
+        }
+        else if (this->strFilesFlag == "sql")
+        {
+            // Divide a tabela em intervalos de rowid, lidos em paralelo por conexões separadas
+            int64_t iLinhas = 0;
+            if (bIntervaloRowid(this->iProximo, this->iUltimo, iLinhas))
             {
-                iContador++;
-                strBlocoDeTexto += line + "\n";
-                if (iContador % this->iTamanhoBatch == 0)
-                {
-                    string value = strBlocoDeTexto;
-                    taskqueue->push_task([this, val = value]() mutable
-                                         { this->create_task(val); });
-                    this->outputBuffer.get_semaphore().wait();
-                    strBlocoDeTexto.clear();
-                }
+                // Com rowids esparsos, o passo cresce para manter ~iTamanhoBatch linhas por intervalo
+                this->dDensidadeRowid = iLinhas > 0 ? max(1.0L, static_cast<long double>(this->iUltimo - this->iProximo + 1) / iLinhas) : 1.0L;
             }
-
-            // Adiciona o último bloco, se houver
-            if (!strBlocoDeTexto.empty())
+            else
             {
-                string value = strBlocoDeTexto;
-                taskqueue->push_task([this, val = value]() mutable
-                                     { this->create_task(val); });
-                this->outputBuffer.get_semaphore().wait();
+                // Tabela sem rowid: lida inteira por uma única tarefa
+                this->bTabelaInteira = true;
             }
         }
-        else if (this->strFilesFlag == "sql")
+        else if (this->strFilesFlag == "mmap" || this->strFilesFlag == "memo")
         {
-            string sql = "SELECT * FROM " + this->strNomeTabela + ";";
-            sqlite3_stmt *stmt;
-            if (sqlite3_prepare_v2(this->bancoDeDados, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
-            {
-                while (sqlite3_step(stmt) == SQLITE_ROW)
-                {
-                    string line;
-                    iContador++;
-                    // Constrói uma linha de dados separada por vírgula
-                    for (size_t i = 0; i < this->strColumnsName.size(); ++i)
-                    {
-                        const char *valor = reinterpret_cast<const char *>(sqlite3_column_text(stmt, i));
-                        line += valor ? valor : "NULL";
-                        if (i < this->strColumnsName.size() - 1)
-                        {
-                            line += ","; // Adiciona vírgula apenas entre os valores
-                        }
-                    }
-
-                    strBlocoDeTexto += line + "\n"; // Adiciona a linha ao bloco
-
-                    // Quando atinge o tamanho do batch, processa o bloco
-                    if (iContador % this->iTamanhoBatch == 0)
-                    {
-                        string value = strBlocoDeTexto;
-                        taskqueue->push_task([this, val = value]() mutable
-                                             { this->create_task(val); });
-                        this->outputBuffer.get_semaphore().wait();
-                        strBlocoDeTexto.clear();
-                    }
-                }
+            // Pula o cabeçalho
+            string_view conteudo = this->strFilesFlag == "mmap" ? this->arquivoMapeado.view() : string_view(this->memoData);
+            size_t fimCabecalho = conteudo.find('\n');
+            conteudo.remove_prefix(fimCabecalho == string_view::npos ? conteudo.size() : fimCabecalho + 1);
 
-                // Se ainda houver dados pendentes no bloco, processa o restante
-                if (!strBlocoDeTexto.empty())
-                {
-                    string value = strBlocoDeTexto;
-                    taskqueue->push_task([this, val = value]() mutable
-                                         { this->create_task(val); });
-                    this->outputBuffer.get_semaphore().wait();
-                }
-
-                sqlite3_finalize(stmt);
+            if (this->bParallelScan || this->strFilesFlag == "mmap")
+            {
+                // Particiona o texto sem copiá-lo; o "mmap" sequencial alinha os blocos na etapa
+                iniciaVarreduraParalela(conteudo);
             }
             else
             {
-                throw runtime_error("Erro ao preparar consulta SQL.");
+                // Processa CSV em memória linha a linha (pulando o cabeçalho)
+                this->ssMemo.str(this->memoData);
+                string line;
+                getline(this->ssMemo, line);
+                this->pEntradaLinhas = &this->ssMemo;
             }
         }
-        else if (this->strFilesFlag == "memo")
+    }
+
+    /**
+     * @brief Gera a próxima tarefa de extração, lendo a entrada só até onde ela precisa.
+     * @param tarefa Saída: função que extrai o próximo batch e o envia ao buffer de saída.
+     * @return false se a entrada acabou.
+     */
+    bool bProximaTarefa(function<void()> &tarefa)
+    {
+        if (!this->bGeracaoIniciada)
+        {
+            iniciaGeracao();
+            this->bGeracaoIniciada = true;
+        }
+
+        if (this->pEntradaLinhas)
         {
-            // Processa CSV em memória (pulando o cabeçalho)
-            stringstream ss(memoData);
+            // Junta as próximas iTamanhoBatch linhas em um bloco de texto, continuando enquanto
+            // houver aspas abertas (um campo entre aspas pode conter quebras de linha)
+            string strBlocoDeTexto;
             string line;
-            // Pula cabeçalho
-            getline(ss, line);
-            while (getline(ss, line))
+            int iContador = 0;
+            bool bDentroDeAspas = false;
+            while ((iContador < max(this->iTamanhoBatch, 1) || bDentroDeAspas) && getline(*this->pEntradaLinhas, line))
             {
                 iContador++;
                 strBlocoDeTexto += line + "\n";
-                if (iContador % this->iTamanhoBatch == 0)
-                {
-                    string value = strBlocoDeTexto;
-                    taskqueue->push_task([this, val = value]() mutable
-                                         { this->create_task(val); });
-                    this->outputBuffer.get_semaphore().wait();
-                    strBlocoDeTexto.clear();
-                }
+                // Cada aspa inverte o estado ("" dentro de um campo inverte duas vezes)
+                bDentroDeAspas ^= count(line.begin(), line.end(), '"') % 2 == 1;
             }
-            // Último bloco
-            if (!strBlocoDeTexto.empty())
+            if (strBlocoDeTexto.empty())
             {
-                string value = strBlocoDeTexto;
-                taskqueue->push_task([this, val = value]() mutable
-                                     { this->create_task(val); });
-                this->outputBuffer.get_semaphore().wait();
+                return false;
             }
+            tarefa = [this, val = std::move(strBlocoDeTexto)]()
+            { this->create_task(val); };
+            return true;
         }
-        // Avisa ao buffer de saída que os dados acabaram
-        finishBuffer();
+
+        if (this->strFilesFlag == "sql" && this->bTabelaInteira)
+        {
+            if (this->iProximo > 0)
+            {
+                return false;
+            }
+            this->iProximo = 1;
+            tarefa = [this]()
+            { this->create_sql_task(0, 0, false); };
+            return true;
+        }
+
+        int64_t iBatch = max(this->iTamanhoBatch, 1);
+        if (this->strFilesFlag == "sql")
+        {
+            if (this->iProximo > this->iUltimo)
+            {
+                return false;
+            }
+            int64_t iPasso = max<int64_t>(iBatch, static_cast<int64_t>(this->dDensidadeRowid * iBatch));
+            int64_t inicio = this->iProximo;
+            int64_t fim = min(this->iUltimo, inicio + iPasso - 1);
+            this->iProximo = fim + 1;
+            tarefa = [this, inicio, fim]()
+            { this->create_sql_task(inicio, fim, true); };
+            return true;
+        }
+
+        if (this->iByteProximo >= this->svConteudo.size())
+        {
+            return false;
+        }
+        size_t inicio = this->iByteProximo;
+        size_t fim = inicio + this->iBytesPorLinha * static_cast<size_t>(iBatch);
+        if (!this->bAlinhaNaEtapa)
+        {
+            // A tarefa alinha o intervalo; o próximo começa onde este termina
+            this->iByteProximo = fim;
+            tarefa = [this, conteudo = this->svConteudo, inicio, fim]()
+            { this->create_task(MappedFile::blocoEntre(conteudo, inicio, fim)); };
+        }
+        else
+        {
+            // Aqui iByteProximo está sempre no início de um registro
+            this->iByteProximo = MappedFile::fronteiraDeRegistro(this->svConteudo, inicio, fim);
+            string_view bloco = this->svConteudo.substr(inicio, this->iByteProximo - inicio);
+            tarefa = [this, bloco]()
+            { this->create_task(bloco); };
+        }
+        return true;
+    }
+
+    /**
+     * @brief Registra o tempo de extração de uma tarefa (ver setAdaptiveBatchSize).
+     * @param iNs Duração da tarefa, em nanossegundos.
+     * @param iBatch Tamanho de batch com que a tarefa foi criada.
+     */
+    void registraMedida(int64_t iNs, int64_t iBatch)
+    {
+        lock_guard<mutex> lock(this->mtxMedidas);
+        this->iNsMedidos += iNs;
+        this->iLinhasMedidas += iBatch;
+    }
+
+    /**
+     * @brief Recalcula iTamanhoBatch a partir das tarefas concluídas e da ocupação do buffer de saída.
+     *
+     * Chamado só por pump, antes de criar cada tarefa; as tarefas já criadas mantêm o tamanho antigo.
+     */
+    void ajustaTamanhoBatch()
+    {
+        int64_t iNs, iLinhas;
+        {
+            lock_guard<mutex> lock(this->mtxMedidas);
+            iNs = this->iNsMedidos;
+            iLinhas = this->iLinhasMedidas;
+            this->iNsMedidos = 0;
+            this->iLinhasMedidas = 0;
+        }
+        if (iLinhas > 0)
+        {
+            // Média móvel, para que um batch atípico (ex.: thread preemptada) não domine o ajuste
+            double dAmostra = static_cast<double>(iNs) / static_cast<double>(iLinhas);
+            this->dNsPorLinha = this->dNsPorLinha > 0 ? 0.7 * this->dNsPorLinha + 0.3 * dAmostra : dAmostra;
+        }
+        if (this->dNsPorLinha <= 0)
+        {
+            // Nenhuma tarefa terminou ainda: mantém o tamanho inicial
+            return;
+        }
+
+        double dOcupacao = static_cast<double>(this->outputBuffer.size()) / max(this->outputBuffer.get_max_size(), 1);
+        double dAlvo = this->dLatenciaAlvoMs * 1e6 / this->dNsPorLinha * (1.0 - 0.5 * min(dOcupacao, 1.0));
+
+        double dAtual = max(this->iTamanhoBatch, 1);
+        dAlvo = clamp(dAlvo, 0.5 * dAtual, 2.0 * dAtual);
+        this->iTamanhoBatch = clamp(static_cast<int>(dAlvo), this->iBatchMinimo, this->iBatchMaximo);
+    }
+
+    /**
+     * @brief Enfileira as tarefas de extração enquanto houver vaga no buffer de saída (ver Stage).
+     * @return true quando a entrada acabou e todas as tarefas terminaram.
+     */
+    bool pump() override
+    {
+        function<void()> tarefa;
+        while (!this->bGeracaoConcluida && this->outputBuffer.try_reserve_slot())
+        {
+            if (this->bBatchAdaptativo)
+            {
+                ajustaTamanhoBatch();
+            }
+            if (!bProximaTarefa(tarefa))
+            {
+                // Avisa ao buffer de saída que os dados acabaram
+                this->outputBuffer.cancel_reservation();
+                this->bGeracaoConcluida = true;
+                finishBuffer();
+                break;
+            }
+
+            taskCreated();
+            taskqueue->push_task([this, tarefa = std::move(tarefa), iBatch = this->iTamanhoBatch]()
+                                 {
+                if (this->bBatchAdaptativo)
+                {
+                    auto inicio = chrono::steady_clock::now();
+                    tarefa();
+                    registraMedida(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count(), iBatch);
+                }
+                else
+                {
+                    tarefa();
+                }
+                this->taskDone(); }, priority());
+        }
+        return this->bGeracaoConcluida && !hasRunningTasks();
     }
 
     /**
@@ -334,74 +931,359 @@ public:
      * @param strTextBlock Bloco de texto com dados CSV ou extraídos do SQL.
      * @return Resultado do método dfSubExtractor.
      */
-    T run(const string &strTextBlock)
+    T run(string_view strTextBlock)
     {
         return dfSubExtractor(strTextBlock);
     }
 
+    // Descreve um valor que não coube no tipo da coluna (para as mensagens de erro)
+    static string strDescreveValor(const Column &coluna, string_view valor)
+    {
+        return "'" + string(valor) + "' na coluna '" + coluna.strGetName() + "' do tipo " + coluna.strGetType();
+    }
+
+    // Conta as linhas do bloco descartadas por valores fora do schema e avisa em cerr
+    void avisaForaDoSchema(size_t iLinhas, const string &strExemplo)
+    {
+        if (iLinhas == 0)
+        {
+            return;
+        }
+        this->iLinhasForaDoSchema += iLinhas;
+        cerr << "Erro: " << iLinhas << " linhas descartadas no bloco por valores fora do schema (ex.: "
+             << strExemplo << "). Defina o tipo com setSchema ou aumente a amostra de inferSchema." << endl;
+    }
+
+    /**
+     * @brief Cria o DataFrame vazio com as colunas de saída (projeção), nos tipos do schema.
+     * @param viSaida Saída: índice no cabeçalho de cada coluna do DataFrame.
+     * @param vCaches Saída: cache do dicionário de cada coluna codificada (nulo nas demais).
+     * @param vcTipo Saída: tipo de cada coluna ('i', 'd', 'b' ou 's'), resolvido fora do laço das linhas.
+     * @return DataFrame sem linhas.
+     */
+    Dataframe dfEstruturaDeSaida(vector<size_t> &viSaida, vector<unique_ptr<StringInterner::Cache>> &vCaches, vector<char> &vcTipo)
+    {
+        vector<string> vstrTipos = getSchema();
+        viSaida = viColunasSaida();
+        vCaches.clear();
+        vCaches.resize(viSaida.size());
+        vcTipo.assign(viSaida.size(), 's');
+
+        // Todas as colunas do batch alocam na mesma arena, devolvida ao pool com o batch
+        shared_ptr<BatchArena> pArena = pPoolArenas ? pPoolArenas->acquire() : nullptr;
+
+        Dataframe dfAuxiliar;
+        for (size_t j = 0; j < viSaida.size(); j++)
+        {
+            const string &col = this->strColumnsName[viSaida[j]];
+            const string &strTipo = vstrTipos[viSaida[j]];
+            dfAuxiliar.vstrColumnsName.push_back(col);
+            vcTipo[j] = strTipo == "string" ? 's' : strTipo[0];
+            if (vcTipo[j] == 's' && find(vstrColunasDicionario.begin(), vstrColunasDicionario.end(), col) != vstrColunasDicionario.end())
+            {
+                dfAuxiliar.columns.push_back(Column::dicionario(col, pDicionario, pArena));
+                vCaches[j] = make_unique<StringInterner::Cache>(*pDicionario);
+            }
+            else
+            {
+                dfAuxiliar.columns.emplace_back(col, strTipo, pArena);
+            }
+        }
+        return dfAuxiliar;
+    }
+
     /**
      * @brief Constrói um DataFrame a partir de um bloco de texto CSV.
      *
+     * O bloco é percorrido uma única vez pelo CsvTokenizer e cada campo é escrito
+     * diretamente na coluna correspondente, sem stringstreams nem std::any por célula.
+     * Colunas com tipo definido (setSchema/inferSchema) são lidas com from_chars.
+     * Linhas com número de campos diferente do cabeçalho ou com campos vazios são descartadas;
+     * linhas com campos inválidos para o tipo da coluna também, com um erro em cerr. Os filtros (addEqualityFilter,
+     * addRangeFilter) são testados nos campos em texto, antes de qualquer cópia, e só as
+     * colunas da projeção (setProjection) são materializadas.
+     *
      * @param strBlocoDeTexto Bloco de texto CSV.
      * @return DataFrame construído a partir do bloco de texto.
      */
-    Dataframe dfSubExtractor(const string &strBlocoDeTexto)
+    Dataframe dfSubExtractor(string_view strBlocoDeTexto)
     {
-        Dataframe dfAuxiliar;
-        dfAuxiliar.vstrColumnsName = this->strColumnsName;
+        size_t numColunas = this->strColumnsName.size();
+        vector<size_t> viSaida;
+        vector<unique_ptr<StringInterner::Cache>> vCaches;
+        vector<char> vcTipo;
+        Dataframe dfAuxiliar = dfEstruturaDeSaida(viSaida, vCaches, vcTipo);
+        size_t numSaida = viSaida.size();
 
-        // Preparar as colunas
-        for (const auto &col : this->strColumnsName)
+        // Estimar o número de linhas para pré-alocar espaço
+        size_t estimatedRows = count(strBlocoDeTexto.begin(), strBlocoDeTexto.end(), '\n') + 1;
+        if (!this->vFiltros.empty())
         {
-            dfAuxiliar.columns.emplace_back(col, "string");
+            estimatedRows = estimatedRows / 4 + 1;
+        }
+        for (size_t j = 0; j < numSaida; j++)
+        {
+            dfAuxiliar.columns[j].reserve(estimatedRows);
+            if (vcTipo[j] == 's')
+                dfAuxiliar.columns[j].reserveBytes(strBlocoDeTexto.size() / max<size_t>(numColunas, 1));
         }
 
-        stringstream ss(strBlocoDeTexto);
-        string line;
+        CsvTokenizer tokenizer;
+        size_t iDescartadas = 0;
+        size_t iForaDoSchema = 0;
+        string strExemplo; // Primeiro valor fora do schema no bloco, para a mensagem de erro
+        tokenizer.parse(strBlocoDeTexto, [&](const vector<string_view> &campos)
+                        {
+            bool valida = campos.size() == numColunas;
+            for (size_t j = 0; valida && j < numColunas; j++)
+            {
+                valida = !campos[j].empty();
+            }
+            if (!valida)
+            {
+                iDescartadas++;
+                return;
+            }
+            for (const auto &filtro : this->vFiltros)
+            {
+                if (!filtro.bAceita(campos[filtro.iColuna]))
+                    return;
+            }
+            for (size_t j = 0; j < numSaida; j++)
+            {
+                string_view campo = campos[viSaida[j]];
+                if (vCaches[j])
+                    dfAuxiliar.columns[j].appendCode(vCaches[j]->codigo(campo));
+                else if (vcTipo[j] == 's')
+                    dfAuxiliar.columns[j].appendString(campo);
+                else if (!dfAuxiliar.columns[j].bAdicionaTexto(campo))
+                {
+                    // Campo inválido para o tipo: desfaz a linha
+                    for (size_t k = 0; k < j; k++)
+                        dfAuxiliar.columns[k].bRemoveUltimoElemento();
+                    if (iForaDoSchema++ == 0)
+                        strExemplo = strDescreveValor(dfAuxiliar.columns[j], campo);
+                    return;
+                }
+            } });
 
-        // Estimar o número de linhas para pré-alocar espaço
-        size_t estimatedRows = count(strBlocoDeTexto.begin(), strBlocoDeTexto.end(), '\n') + 1;
-        for (auto &col : dfAuxiliar.columns)
+        if (iDescartadas > 0)
         {
-            col.reserve(estimatedRows);
+            cerr << "Linhas inválidas descartadas no bloco: " << iDescartadas << endl;
         }
+        avisaForaDoSchema(iForaDoSchema, strExemplo);
 
-        while (getline(ss, line))
+        return dfAuxiliar;
+    }
+
+    /**
+     * @brief Obtém o menor e o maior rowid e o número de linhas da tabela.
+     * @param iMenor Saída: menor rowid.
+     * @param iMaior Saída: maior rowid (menor que iMenor se a tabela estiver vazia).
+     * @param iLinhas Saída: número de linhas.
+     * @return false se a tabela não tiver rowid (WITHOUT ROWID) ou a consulta falhar.
+     */
+    bool bIntervaloRowid(int64_t &iMenor, int64_t &iMaior, int64_t &iLinhas)
+    {
+        string sql = "SELECT min(rowid), max(rowid), count(*) FROM \"" + this->strNomeTabela + "\";";
+        sqlite3_stmt *stmt;
+        if (sqlite3_prepare_v2(this->bancoDeDados, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
         {
-            stringstream ssLine(line);
-            string cell;
-            vector<any> convertedRow;
-            convertedRow.reserve(dfAuxiliar.vstrColumnsName.size());
+            return false;
+        }
+        bool bOk = sqlite3_step(stmt) == SQLITE_ROW;
+        if (bOk && sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+        {
+            iMenor = sqlite3_column_int64(stmt, 0);
+            iMaior = sqlite3_column_int64(stmt, 1);
+            iLinhas = sqlite3_column_int64(stmt, 2);
+        }
+        sqlite3_finalize(stmt);
+        return bOk;
+    }
 
-            size_t colIndex = 0;
-            while (getline(ssLine, cell, ','))
+    /**
+     * @brief Retorna a conexão somente leitura da thread atual, abrindo-a na primeira chamada.
+     *
+     * Cada thread usa a própria conexão, de modo que as leituras dos intervalos não
+     * disputam o mutex interno de uma conexão compartilhada.
+     */
+    sqlite3 *conexaoDaThread()
+    {
+        lock_guard<mutex> lock(this->mtxConexoes);
+        sqlite3 *&conexao = this->umapConexoes[this_thread::get_id()];
+        if (conexao == nullptr)
+        {
+            if (sqlite3_open_v2(this->strCaminhoBanco.c_str(), &conexao,
+                                SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK)
             {
-                // Adiciona a célula diretamente como string
-                convertedRow.emplace_back(cell);
-                colIndex++;
+                string strErro = conexao ? sqlite3_errmsg(conexao) : "sem memória";
+                sqlite3_close(conexao);
+                conexao = nullptr;
+                throw runtime_error("Erro ao abrir o banco de dados: " + strErro);
             }
+        }
+        return conexao;
+    }
 
-            // Completa a linha se necessário
-            while (colIndex < dfAuxiliar.vstrColumnsName.size())
+    /**
+     * @brief Constrói um DataFrame lendo um intervalo de rowids direto das colunas do SQLite.
+     *
+     * Só as colunas da projeção entram no SELECT e os filtros viram a cláusula WHERE, de
+     * modo que o SQLite não devolve linhas nem colunas que seriam descartadas. Os valores são
+     * lidos com sqlite3_column_int64/_double/_text conforme o tipo de cada coluna (getSchema),
+     * sem passar por texto CSV. Como no CSV, linhas com campos nulos ou vazios, ou com textos
+     * que não representam o tipo da coluna, são descartadas (essas últimas com um erro em cerr).
+     * @param inicio Primeiro rowid do intervalo.
+     * @param fim Último rowid do intervalo.
+     * @param bUsaRowid Se false, lê a tabela inteira (tabelas sem rowid).
+     * @return DataFrame com as linhas do intervalo.
+     */
+    Dataframe dfSubExtractorSQL(int64_t inicio, int64_t fim, bool bUsaRowid = true)
+    {
+        vector<size_t> viSaida;
+        vector<unique_ptr<StringInterner::Cache>> vCaches;
+        vector<char> vcTipo;
+        Dataframe dfAuxiliar = dfEstruturaDeSaida(viSaida, vCaches, vcTipo);
+        size_t numSaida = viSaida.size();
+
+        string sql = "SELECT ";
+        for (size_t j = 0; j < numSaida; j++)
+        {
+            sql += (j > 0 ? ", \"" : "\"") + this->strColumnsName[viSaida[j]] + "\"";
+        }
+        sql += " FROM \"" + this->strNomeTabela + "\" WHERE 1";
+        if (bUsaRowid)
+        {
+            sql += " AND rowid BETWEEN ?1 AND ?2";
+        }
+        for (const auto &filtro : this->vFiltros)
+        {
+            // Filtros numéricos em colunas declaradas como texto comparam o valor convertido,
+            // como no CSV (sem isso o SQLite compararia como texto)
+            string strColuna = "\"" + this->strColumnsName[filtro.iColuna] + "\"";
+            bool bColunaNumerica = filtro.iColuna < this->vstrTiposDeclarados.size() &&
+                                   strTipoSQL(this->vstrTiposDeclarados[filtro.iColuna]) != "string";
+            if ((filtro.bIntervalo || filtro.bNumerico) && !bColunaNumerica)
             {
-                convertedRow.emplace_back(string(""));
-                colIndex++;
+                strColuna = "CAST(" + strColuna + " AS REAL)";
             }
+            sql += " AND " + strColuna + (filtro.bIntervalo ? " BETWEEN ? AND ?" : " = ?");
+        }
+        sql += ";";
 
-            dfAuxiliar.adicionaLinha(convertedRow);
+        if (bUsaRowid)
+        {
+            for (auto &coluna : dfAuxiliar.columns)
+            {
+                coluna.reserve(static_cast<size_t>((fim - inicio + 1) / this->dDensidadeRowid));
+            }
         }
 
+        sqlite3 *conexao = conexaoDaThread();
+        sqlite3_stmt *stmt;
+        if (sqlite3_prepare_v2(conexao, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            throw runtime_error("Erro ao preparar consulta SQL: " + string(sqlite3_errmsg(conexao)));
+        }
+        int iParametro = 1;
+        if (bUsaRowid)
+        {
+            sqlite3_bind_int64(stmt, iParametro++, inicio);
+            sqlite3_bind_int64(stmt, iParametro++, fim);
+        }
+        for (const auto &filtro : this->vFiltros)
+        {
+            iParametro = filtro.iVincula(stmt, iParametro);
+        }
+
+        size_t iDescartadas = 0;
+        size_t iForaDoSchema = 0;
+        string strExemplo; // Primeiro valor fora do schema no bloco, para a mensagem de erro
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            for (size_t j = 0; j < numSaida; j++)
+            {
+                Column &coluna = dfAuxiliar.columns[j];
+                int iTipoSQL = vcTipo[j] == 's' ? SQLITE_TEXT : sqlite3_column_type(stmt, j);
+                bool valido = true;
+                if (iTipoSQL == SQLITE_NULL)
+                {
+                    valido = false;
+                }
+                else if (vcTipo[j] == 'i' && iTipoSQL == SQLITE_INTEGER)
+                {
+                    coluna.appendInt(sqlite3_column_int64(stmt, j));
+                }
+                else if (vcTipo[j] == 'd' && (iTipoSQL == SQLITE_FLOAT || iTipoSQL == SQLITE_INTEGER))
+                {
+                    coluna.appendDouble(sqlite3_column_double(stmt, j));
+                }
+                else
+                {
+                    // Textos (e valores guardados com tipo diferente do declarado) passam pelo parser tipado
+                    const char *texto = reinterpret_cast<const char *>(sqlite3_column_text(stmt, j));
+                    string_view valor(texto ? texto : "", texto ? sqlite3_column_bytes(stmt, j) : 0);
+                    if (valor.empty())
+                        valido = false;
+                    else if (vCaches[j])
+                        coluna.appendCode(vCaches[j]->codigo(valor));
+                    else if (vcTipo[j] == 's')
+                        coluna.appendString(valor);
+                    else if (!coluna.bAdicionaTexto(valor))
+                    {
+                        // Valor que não é do tipo da coluna: desfaz a linha
+                        for (size_t k = 0; k < j; k++)
+                            dfAuxiliar.columns[k].bRemoveUltimoElemento();
+                        if (iForaDoSchema++ == 0)
+                            strExemplo = strDescreveValor(coluna, valor);
+                        break;
+                    }
+                }
+
+                if (!valido)
+                {
+                    // Desfaz a linha
+                    for (size_t k = 0; k < j; k++)
+                        dfAuxiliar.columns[k].bRemoveUltimoElemento();
+                    iDescartadas++;
+                    break;
+                }
+            }
+        }
+        sqlite3_finalize(stmt);
+
+        if (iDescartadas > 0)
+        {
+            cerr << "Linhas inválidas descartadas no bloco: " << iDescartadas << endl;
+        }
+        avisaForaDoSchema(iForaDoSchema, strExemplo);
+
         return dfAuxiliar;
     }
 
+    /**
+     * @brief Cria uma tarefa que extrai um intervalo de rowids e envia o resultado ao buffer.
+     * @param inicio Primeiro rowid do intervalo.
+     * @param fim Último rowid do intervalo.
+     * @param bUsaRowid Se false, lê a tabela inteira.
+     */
+    void create_sql_task(int64_t inicio, int64_t fim, bool bUsaRowid)
+    {
+        T data = dfSubExtractorSQL(inicio, fim, bUsaRowid);
+        data.lacraArenas();
+        this->outputBuffer.push(std::move(data));
+    }
+
     /**
      * @brief Cria uma tarefa a partir de um bloco de texto e realiza a extração dos dados.
      * @param value Bloco de texto a ser processado.
      */
-    void create_task(const string &value)
+    void create_task(string_view value)
     {
         T data = run(value);
-        this->outputBuffer.push(data);
+        data.lacraArenas();
+        this->outputBuffer.push(std::move(data));
     }
 
     /**
@@ -418,7 +1300,7 @@ public:
      */
     void finishBuffer()
     {
-        outputBuffer.finalizeInput();
+        outputBuffer.close();
     }
 
     /**
@@ -430,7 +1312,7 @@ public:
 // Classe base genérica para carregadores (última etapa do pipeline)
 // T: Tipo dos dados que serão consumidos (ex: DataFrame, estrutura customizada, etc.)
 template <typename T>
-class Loader
+class Loader : public Stage
 {
 protected:
     // Buffer de entrada do qual os dados serão consumidos
@@ -439,6 +1321,10 @@ protected:
     // Ponteiro para a fila de tarefas responsável pela execução concorrente
     TaskQueue *taskqueue = nullptr;
 
+    // Colunas usadas pelo loader (ver declareColumns)
+    vector<string> vstrColunasLidas;
+    bool bColunasDeclaradas = false;
+
 public:
     /**
      * @brief Construtor do Loader
@@ -464,39 +1350,42 @@ public:
     TaskQueue *get_taskqueue() const { return taskqueue; }
 
     /**
-     * Método responsável por enfileirar as tarefas de carregamento.
-     * Extrai dados do buffer de entrada e os envia para a fila de execução paralela.
+     * @brief Retorna o buffer de entrada.
      */
-    void enqueue_tasks()
-    {
-        // Enquanto o buffer de entrada ainda não indicou o fim dos dados
-        while (!(input_buffer.atomicGetInputDataFinished()))
-        {
-
-            // Tenta extrair um dado do buffer
-            std::optional<T> maybe_value = input_buffer.pop(false, true);
+    Buffer<T> &get_input_buffer() const { return input_buffer; }
 
-            // Se não conseguir pegar nenhum dado (buffer vazio no momento), encerra o loop
-            if (!maybe_value.has_value())
-            {
-                break;
-            }
+    /**
+     * @brief Declara as colunas usadas pelo loader, para a poda de colunas do Manager.
+     * Sem essa declaração, o Manager considera que o loader precisa de todas as colunas.
+     * @param vstrColunas Colunas lidas por `run`.
+     */
+    void declareColumns(const vector<string> &vstrColunas)
+    {
+        vstrColunasLidas = vstrColunas;
+        bColunasDeclaradas = true;
+    }
 
-            // Move o valor extraído
-            T value = std::move(*maybe_value);
+    // Getters da declaração de colunas
+    bool hasDeclaredColumns() const { return bColunasDeclaradas; }
+    const vector<string> &getReadColumns() const { return vstrColunasLidas; }
 
+    /**
+     * Método responsável por enfileirar as tarefas de carregamento (ver Stage).
+     * Extrai os dados disponíveis no buffer de entrada e os envia para a fila de execução paralela.
+     * @return true quando a entrada acabou e todas as tarefas terminaram.
+     */
+    bool pump() override
+    {
+        // Retira tudo o que já chegou, sem esperar
+        while (std::optional<T> maybe_value = input_buffer.pop(true))
+        {
             // Enfileira a tarefa na fila de execução, chamando o método `create_task`
-            taskqueue->push_task([this, val = std::move(value)]() mutable
-                                 { this->create_task(std::move(val)); });
+            taskCreated();
+            taskqueue->push_task([this, val = std::move(*maybe_value)]() mutable
+                                 { this->create_task(std::move(val)); }, priority());
         }
 
-        // Quando termina de consumir todos os dados:
-        // Decrementa o número de loaders ativos
-
-        taskqueue->getNumberOfLoaders().wait();
-
-        // Notifica a fila de que este loader terminou
-        taskqueue->notifyAll();
+        return input_buffer.is_finished() && !hasRunningTasks();
     }
 
     /**
@@ -512,6 +1401,7 @@ public:
     void create_task(T value)
     {
         run(std::move(value));
+        taskDone();
     }
 };
 
@@ -1,97 +1,261 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 
-#include <mutex>
-#include <condition_variable>
-#include <queue>
+#include <atomic>
+#include <memory>
 #include <optional>
+#include <thread>
+#include <cstdint>
 #include <iostream>
-#include "Semaphore.h"
+#include <vector>
+#include <functional>
 
 // Classe Buffer - estrutura thread-safe para comunicação entre etapas do pipeline
-// Usa mutex, semáforo e condition_variable para garantir segurança em ambientes concorrentes
+//
+// Implementada como um anel circular limitado sem locks, com múltiplos produtores e
+// múltiplos consumidores (algoritmo de Vyukov): cada posição guarda um número de sequência
+// que indica se ela está livre para escrita ou pronta para leitura, e produtores/consumidores
+// disputam apenas um compare-and-swap no índice correspondente.
+//
+// O controle de capacidade (backpressure) é feito por reserva de vagas: o produtor chama
+// reserve_slot() (ou try_reserve_slot(), sem bloquear) antes de criar a tarefa que fará o
+// push, e a vaga só é devolvida quando o consumidor retira o valor. Assim, o número de vagas livres também diz se ainda há
+// valores a caminho, e o fim dos dados é detectado sem flags extras: depois de close(),
+// o buffer termina quando não há mais nenhuma vaga reservada nem valor armazenado.
+// As esperas usam std::atomic::wait/notify (C++20), sem mutex nem condition_variable.
+// As etapas do pipeline não esperam nos buffers: o escalonador registra funções (on_data,
+// on_space) que as acordam quando chegam dados ou uma vaga é liberada.
 
 template <typename T>
 class Buffer {
 private:
-    std::queue<T> queue;             // Fila que armazena os dados
-    std::mutex mtx;                  // Mutex para garantir acesso exclusivo à fila
-    std::mutex mtx_2;
-    std::condition_variable cond;    // Variável de condição para controle de espera/notificação
-    int max_size;                    // Capacidade máxima do buffer
-    Semaphore semaphore;             // Semáforo para controlar o número de elementos permitidos
+    // Posição do anel: o número de sequência controla de quem é a vez
+    struct Cell {
+        std::atomic<size_t> sequence;
+        std::optional<T> value;
+    };
 
-    // Flag que indica se todas as tarefas que produzem dados para esse buffer já foram criadas
-    bool inputTasksCreated = false;
+    int max_size;                            // Capacidade máxima do buffer
+    size_t mask;                             // Tamanho do anel - 1 (o anel tem tamanho potência de 2)
+    std::unique_ptr<Cell[]> cells;           // Anel de posições
 
-    // Flag que indica que os dados de entrada acabaram completamente
-    bool inputDataFinished = false;
+    // Índices de escrita e de leitura, em linhas de cache separadas para evitar falso compartilhamento
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+
+    // Número de vagas livres (nem reservadas, nem ocupadas)
+    alignas(64) std::atomic<int> freeSlots;
+    // Contador incrementado a cada push e a cada mudança de estado; os consumidores esperam nele
+    std::atomic<uint32_t> signal{0};
+    // Indica que todas as tarefas que produzem dados para esse buffer já foram criadas
+    std::atomic<bool> closed{false};
+
+    // Tenta inserir no anel; só falha se o anel estiver cheio
+    bool try_enqueue(T &value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value.emplace(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Tenta retirar do anel; falha se não houver valor publicado
+    bool try_dequeue(std::optional<T> &out) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        out.emplace(std::move(*cell->value));
+        cell->value.reset();
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Funções chamadas quando chegam dados ou o estado muda (consumidores) e quando uma
+    // vaga é liberada por pop (produtor); usadas pelo escalonador para acordar as etapas
+    std::vector<std::function<void()>> dataListeners;
+    std::vector<std::function<void()>> spaceListeners;
+
+    static void call_all(const std::vector<std::function<void()>> &listeners) {
+        for (const auto &listener : listeners) {
+            listener();
+        }
+    }
+
+    // Acorda todos os consumidores (usado quando o estado do buffer muda)
+    void wake_consumers() {
+        signal.fetch_add(1);
+        signal.notify_all();
+        call_all(dataListeners);
+    }
+
+    // Devolve a vaga de um valor retirado
+    void release_slot() {
+        int livres = freeSlots.fetch_add(1) + 1;
+        freeSlots.notify_one();
+
+        // Se essa era a última vaga em uso e o buffer já foi fechado, os dados acabaram
+        if (livres == max_size && closed.load()) {
+            wake_consumers();
+        }
+    }
 
 public:
     /**
      * Construtor do buffer.
      * @param max_size - Capacidade máxima do buffer (default: 5000)
      */
-    Buffer(int max_size = 5000) : max_size(max_size), semaphore(max_size) {}
+    Buffer(int max_size = 5000) : max_size(max_size), freeSlots(max_size) {
+        size_t capacity = 1;
+        while (capacity < static_cast<size_t>(max_size)) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        cells.reset(new Cell[capacity]);
+        for (size_t i = 0; i < capacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    Buffer(const Buffer &) = delete;
+    Buffer &operator=(const Buffer &) = delete;
 
     /**
-     * Insere um valor no buffer.
-     * Deve ser chamado somente após adquirir o semáforo externamente (em geral).
+     * Reserva uma vaga no buffer, bloqueando enquanto ele estiver cheio.
+     * Deve ser chamado antes de cada push (em geral, ao criar a tarefa que fará o push).
      */
-    void push(T value) {
-        std::lock_guard<std::mutex> lock(mtx);
-        queue.push(std::move(value));
-        cond.notify_one(); // Acorda uma thread consumidora que esteja esperando
+    void reserve_slot() {
+        int livres = freeSlots.load();
+        while (true) {
+            if (livres > 0) {
+                if (freeSlots.compare_exchange_weak(livres, livres - 1)) {
+                    return;
+                }
+            } else {
+                freeSlots.wait(livres);
+                livres = freeSlots.load();
+            }
+        }
     }
 
     /**
-     * Retira um valor do buffer.
-     * @param multiInput - se true, a verificação inicial retorna null se a fila estiver vazia (usado em pipelines com múltiplas entradas)
-     * @param test - parâmetro reservado para testes futuros (atualmente não utilizado)
-     * @return std::optional<T> contendo o valor, ou nullopt se os dados de entrada acabaram
+     * Tenta reservar uma vaga sem bloquear.
+     * @return true se a vaga foi reservada; false se o buffer estava cheio
      */
-    std::optional<T> pop(bool multiInput = false, bool test = false) {
-        std::unique_lock<std::mutex> lock(mtx);
-        
-        // Se for multi-input e estiver vazio, retorna imediatamente
-        if (multiInput && queue.empty()) {
-            return std::nullopt;
+    bool try_reserve_slot() {
+        int livres = freeSlots.load();
+        while (livres > 0) {
+            if (freeSlots.compare_exchange_weak(livres, livres - 1)) {
+                return true;
+            }
         }
+        return false;
+    }
+
+    /**
+     * Devolve uma vaga reservada que não será usada (a tarefa não produziu dados).
+     * Diferente da vaga devolvida por pop, não acorda o produtor (ver on_space).
+     */
+    void cancel_reservation() {
+        release_slot();
+    }
 
-        // Espera até que tenha dados ou os dados acabem
-        cond.wait(lock, [this] {
-            return (!queue.empty()) || (getInputDataFinished());
-        });
+    /**
+     * Retorna se há pelo menos uma vaga livre (sem reservá-la).
+     */
+    bool has_free_slot() const {
+        return freeSlots.load() > 0;
+    }
 
-        // Se os dados acabaram, não tem mais o que processar
-        if (getInputDataFinished()) {
-            return std::nullopt;
+    /**
+     * Insere um valor no buffer, movendo-o para dentro da vaga (o batch não é copiado).
+     * Para enviar o mesmo batch a mais de um buffer, o chamador faz as cópias explicitamente.
+     * Deve ser chamado somente após reservar a vaga com reserve_slot().
+     */
+    void push(T&& value) {
+        // Com a vaga reservada o anel nunca está cheio; o laço só protege contra uso incorreto
+        while (!try_enqueue(value)) {
+            std::this_thread::yield();
         }
+        // Acorda uma thread consumidora que esteja esperando
+        signal.fetch_add(1);
+        signal.notify_one();
+        call_all(dataListeners);
+    }
 
-        // Retira o próximo valor
-        T value = std::move(queue.front());
-        queue.pop();
+    /**
+     * Retira um valor do buffer.
+     * @param multiInput - se true, retorna null imediatamente se o buffer estiver vazio (usado em pipelines com múltiplas entradas)
+     * @return std::optional<T> contendo o valor, ou nullopt se os dados de entrada acabaram
+     */
+    std::optional<T> pop(bool multiInput = false) {
+        std::optional<T> value;
+        while (true) {
+            uint32_t seen = signal.load();
 
-        // Libera espaço no buffer (semáforo sobe)
-        semaphore.notify();
+            if (try_dequeue(value)) {
+                release_slot();
+                call_all(spaceListeners);
+                return value;
+            }
 
-        // Se todas as tarefas de input foram criadas e o buffer está totalmente vazio
-        if (getInputTasksCreated() && get_semaphore().get_count() == get_max_size()) {
-            setInputDataFinished();
+            // Se for multi-input ou se os dados acabaram, não espera
+            if (multiInput || is_finished()) {
+                return std::nullopt;
+            }
+
+            // Espera até que algo seja inserido ou o estado do buffer mude
+            signal.wait(seen);
         }
+    }
 
-        return value;
+    /**
+     * Registra uma função chamada a cada push e quando o buffer é fechado ou termina.
+     * Deve ser chamado antes de o pipeline começar a rodar.
+     */
+    void on_data(std::function<void()> listener) {
+        dataListeners.push_back(std::move(listener));
     }
 
-    // Acessa o semáforo do buffer (usado externamente para controle de concorrência)
-    Semaphore& get_semaphore() {
-        return semaphore;
+    /**
+     * Registra uma função chamada sempre que um pop libera uma vaga.
+     * Deve ser chamado antes de o pipeline começar a rodar.
+     */
+    void on_space(std::function<void()> listener) {
+        spaceListeners.push_back(std::move(listener));
     }
 
-    // Retorna o número atual de elementos na fila
+    // Retorna o número atual de elementos na fila (aproximado sob concorrência)
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mtx);
-        return queue.size();
+        size_t escritos = enqueuePos.load();
+        size_t lidos = dequeuePos.load();
+        return escritos > lidos ? escritos - lidos : 0;
     }
 
     // Retorna a capacidade máxima do buffer
@@ -101,49 +265,26 @@ public:
 
     /**
      * Indica que todas as tarefas que irão produzir dados para esse buffer já foram criadas.
-     * Importante para que o consumidor saiba que não virão mais tarefas no futuro.
+     * Chamado pelas etapas do pipeline para avisar que não haverá mais reservas.
      */
-    void setInputTasksCreated() {
-        std::lock_guard<std::mutex> lock(mtx_2);
-        inputTasksCreated = true;
-        cond.notify_all(); // Acorda qualquer thread que esteja esperando
-    }
-
-    // Retorna se as tarefas de input já foram todas criadas
-    bool getInputTasksCreated() {
-        return inputTasksCreated;
-    }
-
-    // Retorna se os dados de entrada acabaram (sem locking)
-    bool getInputDataFinished() {
-        return inputDataFinished;
+    void close() {
+        closed.store(true);
+        wake_consumers(); // Acorda quem estiver esperando
     }
 
-    // Retorna se os dados de entrada acabaram (com locking - seguro em ambientes concorrentes)
-    bool atomicGetInputDataFinished() {
-        // std::lock_guard<std::mutex> lock(mtx_3);
-        return inputDataFinished;
+    // Retorna se o buffer foi fechado pelos produtores
+    bool is_closed() const {
+        return closed.load();
     }
 
-    // Define explicitamente que os dados de entrada acabaram
-    void setInputDataFinished() {
-        inputDataFinished = true;
-    }
-
-    // Método chamado pelas etapas finais do pipeline para avisar que não haverá mais dados
-    void finalizeInput() {
-        std::lock_guard<std::mutex> lock(mtx_2);
-        inputTasksCreated = true;
-
-        // Se o buffer está vazio, os dados realmente acabaram
-        if (get_semaphore().get_count() == get_max_size()) {
-            inputDataFinished = true;
-        }
-
-        // Acorda quem estiver esperando
-        cond.notify_all();
+    /**
+     * Retorna se os dados de entrada acabaram: o buffer foi fechado e não há
+     * vagas reservadas (tarefas ainda produzindo) nem valores armazenados.
+     */
+    bool is_finished() const {
+        return closed.load() && freeSlots.load() == max_size;
     }
 };
 
 
-#endif // BUFFER_H
\ No newline at end of file
+#endif // BUFFER_H
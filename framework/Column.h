@@ -0,0 +1,1066 @@
+#ifndef COLUMN_H
+#define COLUMN_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <typeinfo>
+#include <cstdint>
+#include <charconv>
+#include <functional>
+#include <any>
+#include <memory>
+#include <atomic>
+#include "Series.h"
+#include <memory_resource>
+#include "StringInterner.h"
+#include "Arena.h"
+
+using namespace std;
+
+/**
+ * @brief Converte um valor do tipo std::any para string.
+ * @param value Valor a ser convertido.
+ * @return String representando o valor ou mensagem de erro se falhar.
+ */
+static inline string anyToString(const any &value)
+{
+    try
+    {
+        if (value.type() == typeid(string))
+        {
+            return any_cast<string>(value);
+        }
+        else if (value.type() == typeid(const char *))
+        {
+            return string(any_cast<const char *>(value));
+        }
+        else if (value.type() == typeid(bool))
+        {
+            return any_cast<bool>(value) ? "true" : "false";
+        }
+        else if (value.type() == typeid(int))
+        {
+            return to_string(any_cast<int>(value));
+        }
+        else if (value.type() == typeid(int64_t))
+        {
+            return to_string(any_cast<int64_t>(value));
+        }
+        else if (value.type() == typeid(double))
+        {
+            return to_string(any_cast<double>(value));
+        }
+        else
+        {
+            return "[Unsupported Type]";
+        }
+    }
+    catch (const bad_any_cast &)
+    {
+        return "[Error]";
+    }
+}
+
+/**
+ * @class Column
+ * @brief Coluna tipada e contígua usada internamente pelo Dataframe.
+ *
+ * Cada coluna guarda seus valores em um único buffer do tipo declarado: inteiros em
+ * int64_t, reais em double, booleanos em uint8_t e strings no formato offsets + bytes
+ * (todas as strings concatenadas em um único buffer). Dessa forma cada célula numérica
+ * ocupa 8 bytes sem alocação no heap e as varreduras percorrem memória contígua.
+ *
+ * Os tipos aceitos são os mesmos nomes usados pela Series: "int", "double", "bool" e "string".
+ *
+ * Colunas de strings com poucos valores distintos (chaves de agrupamento e de join) podem
+ * ser codificadas por dicionário (Column::dicionario): cada célula vira um código uint32_t
+ * de um StringInterner compartilhado, e comparações e hashes passam a ser operações inteiras.
+ * O tipo continua sendo "string" e getString() devolve o texto do dicionário.
+ */
+class Column
+{
+private:
+    string strColumnName;      ///< Nome da coluna
+    string strColumnType;      ///< Tipo da coluna ("int", "double", "bool" ou "string")
+    shared_ptr<StringInterner> pDicionario; ///< Dicionário dos códigos (nulo em colunas comuns)
+
+    /**
+     * @brief Buffers de uma coluna, compartilhados entre as cópias da coluna.
+     *
+     * Copiar uma Column só incrementa a contagem de referências destes buffers; a coluna
+     * que for alterada enquanto eles estiverem compartilhados faz antes a sua própria cópia
+     * (copy-on-write, ver m()). Os buffers podem estar na arena de um batch, que fica viva
+     * enquanto eles existirem; a cópia do copy-on-write vai sempre para o heap. Depois que o
+     * batch é entregue (lacraArena), a arena não recebe mais alocações: a primeira alteração
+     * também copia os buffers para o heap.
+     */
+    struct Dados
+    {
+        // Declarada primeiro para ser destruída por último, depois dos buffers que estão nela
+        shared_ptr<BatchArena> pArena;  ///< Arena dos buffers abaixo (nula se vierem do heap)
+        pmr::vector<int64_t> viData;    ///< Dados de colunas "int"
+        pmr::vector<double> vdData;     ///< Dados de colunas "double"
+        pmr::vector<uint8_t> vbData;    ///< Dados de colunas "bool"
+        pmr::vector<size_t> vOffsets;   ///< Offsets de início de cada string (tamanho n + 1)
+        pmr::string strBytes;           ///< Bytes de todas as strings concatenadas
+        pmr::vector<uint32_t> viCodigos; ///< Códigos de colunas "string" codificadas por dicionário
+        bool bLacrado = false;          ///< Buffers na arena de um batch já entregue (só leitura)
+        atomic<uint32_t> iRefs{1};      ///< Colunas que usam estes buffers (ver RefDados)
+
+        explicit Dados(pmr::memory_resource *recurso = pmr::get_default_resource())
+            : viData(recurso), vdData(recurso), vbData(recurso), vOffsets(1, 0, recurso),
+              strBytes(recurso), viCodigos(recurso) {}
+
+        Dados(const Dados &other)
+            : viData(other.viData), vdData(other.vdData), vbData(other.vbData), vOffsets(other.vOffsets),
+              strBytes(other.strBytes), viCodigos(other.viCodigos) {}
+    };
+
+    /**
+     * @brief Referência contada aos buffers de uma coluna.
+     *
+     * A contagem fica nos próprios Dados para que bUnica() a leia com ordem acquire:
+     * shared_ptr::use_count() é uma leitura relaxed, e uma coluna que a visse igual a 1
+     * poderia alterar os buffers antes que as leituras feitas por outra thread, por uma
+     * cópia já destruída, tivessem terminado. Com o acquire, a liberação da cópia (acq_rel)
+     * acontece antes da escrita.
+     */
+    class RefDados
+    {
+    private:
+        Dados *p = nullptr;
+
+        void solta()
+        {
+            if (p && p->iRefs.fetch_sub(1, memory_order_acq_rel) == 1)
+                delete p;
+            p = nullptr;
+        }
+
+    public:
+        RefDados() = default;
+        explicit RefDados(Dados *p) : p(p) {}
+        RefDados(const RefDados &other) : p(other.p)
+        {
+            if (p)
+                p->iRefs.fetch_add(1, memory_order_relaxed);
+        }
+        RefDados(RefDados &&other) noexcept : p(other.p) { other.p = nullptr; }
+        RefDados &operator=(const RefDados &other)
+        {
+            if (p != other.p)
+            {
+                RefDados copia(other);
+                swap(p, copia.p);
+            }
+            return *this;
+        }
+        RefDados &operator=(RefDados &&other) noexcept
+        {
+            if (this != &other)
+            {
+                solta();
+                p = other.p;
+                other.p = nullptr;
+            }
+            return *this;
+        }
+        ~RefDados() { solta(); }
+
+        void reset() { solta(); }
+        // Indica se esta é a única referência aos buffers
+        bool bUnica() const { return p->iRefs.load(memory_order_acquire) == 1; }
+        Dados *get() const { return p; }
+        Dados &operator*() const { return *p; }
+        Dados *operator->() const { return p; }
+        explicit operator bool() const { return p != nullptr; }
+    };
+
+    RefDados pDados; ///< Buffers da coluna (nulo: coluna vazia ainda sem buffers)
+
+    // Buffers vazios usados para leitura de colunas sem buffers
+    static const Dados &vazio()
+    {
+        static const Dados dados;
+        return dados;
+    }
+
+    // Buffers para leitura
+    const Dados &d() const { return pDados ? *pDados : vazio(); }
+
+    // Buffers para escrita: cria-os, ou copia-os se estiverem compartilhados com outra coluna
+    // ou numa arena lacrada
+    Dados &m()
+    {
+        if (!pDados)
+            pDados = RefDados(new Dados());
+        else if (!pDados.bUnica() || pDados->bLacrado)
+            pDados = RefDados(new Dados(*pDados));
+        return *pDados;
+    }
+
+    /**
+     * @brief Normaliza o nome do tipo, tratando tipos desconhecidos como string.
+     * @param strTipo Nome do tipo informado.
+     * @return Nome do tipo suportado.
+     */
+    static string normalizaTipo(const string &strTipo)
+    {
+        if (strTipo == "int" || strTipo == "double" || strTipo == "bool")
+            return strTipo;
+        return "string";
+    }
+
+    /**
+     * @brief Lê um booleano em texto ("true"/"false"/"1"/"0", sem diferenciar maiúsculas).
+     * @return 1, 0, ou -1 se o texto não for um booleano.
+     */
+    static int iLeBool(string_view valor)
+    {
+        auto igual = [&](string_view palavra)
+        {
+            return valor.size() == palavra.size() &&
+                   equal(valor.begin(), valor.end(), palavra.begin(),
+                         [](char a, char b) { return tolower(static_cast<unsigned char>(a)) == b; });
+        };
+        if (valor == "1" || igual("true"))
+            return 1;
+        if (valor == "0" || igual("false"))
+            return 0;
+        return -1;
+    }
+
+public:
+    /**
+     * @brief Construtor padrão (coluna de strings sem nome).
+     */
+    Column() : strColumnType("string") {}
+
+    /**
+     * @brief Construtor com nome e tipo.
+     * @param columnName Nome da coluna.
+     * @param columnType Tipo da coluna.
+     */
+    explicit Column(const string &columnName, const string &columnType = "string")
+        : strColumnName(columnName), strColumnType(normalizaTipo(columnType)) {}
+
+    /**
+     * @brief Construtor com nome e tipo, alocando os dados na arena de um batch.
+     * @param columnName Nome da coluna.
+     * @param columnType Tipo da coluna.
+     * @param pArena Arena do batch (ver ArenaPool); se nula, usa o heap.
+     */
+    Column(const string &columnName, const string &columnType, shared_ptr<BatchArena> pArena)
+        : strColumnName(columnName), strColumnType(normalizaTipo(columnType))
+    {
+        if (pArena)
+        {
+            pDados = RefDados(new Dados(pArena.get()));
+            pDados->pArena = std::move(pArena);
+        }
+    }
+
+    // Cópias compartilham os buffers (copy-on-write); movimentos os transferem
+    Column(const Column &) = default;
+    Column(Column &&) noexcept = default;
+    Column &operator=(const Column &) = default;
+    Column &operator=(Column &&) noexcept = default;
+
+    /**
+     * @brief Indica se os buffers desta coluna são os mesmos de outra (sem cópia entre elas).
+     */
+    bool bCompartilhaDados(const Column &other) const { return pDados && pDados.get() == other.pDados.get(); }
+
+    /**
+     * @brief Lacra os buffers que estão na arena do batch: as alterações seguintes vão para o heap.
+     *
+     * Chamado pelo extrator ao entregar o batch. A partir daí as cópias da coluna podem ser
+     * alteradas por etapas diferentes ao mesmo tempo e a BatchArena não é thread-safe, então
+     * nenhuma delas volta a alocar na arena.
+     */
+    void lacraArena()
+    {
+        if (pDados && pDados->pArena)
+            pDados->bLacrado = true;
+    }
+
+    /**
+     * @brief Constrói uma coluna tipada a partir de uma Series.
+     * @tparam T Tipo dos dados da Series.
+     * @param serie Series de origem.
+     * @return Coluna com os mesmos valores.
+     */
+    template <typename T>
+    static Column fromSeries(const Series<T> &serie)
+    {
+        Column coluna(serie.strGetName(), serie.strGetType());
+        coluna.reserve(serie.iGetSize());
+        for (size_t i = 0; i < serie.iGetSize(); i++)
+        {
+            if (!coluna.bAdicionaElemento(serie.retornaElemento(i)))
+            {
+                throw invalid_argument("Erro ao converter elemento da coluna " + serie.strGetName());
+            }
+        }
+        return coluna;
+    }
+
+    /**
+     * @brief Constrói uma coluna double a partir de um vetor já calculado.
+     *
+     * Os valores são copiados uma vez para o buffer da coluna (que usa outro alocador).
+     * @param columnName Nome da coluna.
+     * @param vdValores Valores da coluna.
+     */
+    static Column fromDoubleVector(const string &columnName, const vector<double> &vdValores)
+    {
+        Column coluna(columnName, "double");
+        coluna.m().vdData.assign(vdValores.begin(), vdValores.end());
+        return coluna;
+    }
+
+    /**
+     * @brief Cria uma coluna de strings vazia codificada pelo dicionário informado.
+     * @param columnName Nome da coluna.
+     * @param pDicionario Dicionário compartilhado pelas colunas que devem ter códigos comparáveis.
+     * @param pArena Arena do batch para os códigos (opcional).
+     */
+    static Column dicionario(const string &columnName, shared_ptr<StringInterner> pDicionario,
+                             shared_ptr<BatchArena> pArena = nullptr)
+    {
+        Column coluna(columnName, "string", std::move(pArena));
+        coluna.pDicionario = std::move(pDicionario);
+        return coluna;
+    }
+
+    /**
+     * @brief Altera o nome da coluna.
+     * @param strNovoNome Novo nome a ser definido.
+     */
+    void setName(const string &strNovoNome) { strColumnName = strNovoNome; }
+
+    /**
+     * @brief Retorna o nome da coluna.
+     */
+    string strGetName() const { return strColumnName; }
+
+    /**
+     * @brief Retorna o tipo da coluna.
+     */
+    string strGetType() const { return strColumnType; }
+
+    bool isInt() const { return strColumnType == "int"; }
+    bool isDouble() const { return strColumnType == "double"; }
+    bool isBool() const { return strColumnType == "bool"; }
+    bool isString() const { return strColumnType == "string"; }
+    bool isDictionary() const { return pDicionario != nullptr; }
+
+    /**
+     * @brief Indica se os códigos desta coluna e de outra vêm do mesmo dicionário.
+     */
+    bool bMesmoDicionario(const Column &other) const
+    {
+        return pDicionario != nullptr && pDicionario == other.pDicionario;
+    }
+
+    /**
+     * @brief Indica se a coluna é numérica (int ou double).
+     */
+    bool isNumeric() const { return isInt() || isDouble(); }
+
+    /**
+     * @brief Retorna o número de elementos na coluna.
+     */
+    size_t iGetSize() const
+    {
+        if (isInt())
+            return d().viData.size();
+        if (isDouble())
+            return d().vdData.size();
+        if (isBool())
+            return d().vbData.size();
+        if (isDictionary())
+            return d().viCodigos.size();
+        return d().vOffsets.size() - 1;
+    }
+
+    /**
+     * @brief Pré-aloca espaço para n elementos.
+     * @param n Número de elementos a reservar.
+     */
+    void reserve(size_t n)
+    {
+        if (isInt())
+            m().viData.reserve(n);
+        else if (isDouble())
+            m().vdData.reserve(n);
+        else if (isBool())
+            m().vbData.reserve(n);
+        else if (isDictionary())
+            m().viCodigos.reserve(n);
+        else
+            m().vOffsets.reserve(n + 1);
+    }
+
+    /**
+     * @brief Pré-aloca espaço para os bytes das strings.
+     * @param n Número de bytes a reservar.
+     */
+    void reserveBytes(size_t n)
+    {
+        if (!isDictionary())
+            m().strBytes.reserve(n);
+    }
+
+    /**
+     * @brief Remove todos os dados da coluna, mantendo nome e tipo.
+     */
+    void clear()
+    {
+        // Buffers compartilhados com outra coluna ou lacrados não são tocados: esta só deixa de usá-los
+        if (pDados && (!pDados.bUnica() || pDados->bLacrado))
+        {
+            pDados.reset();
+            return;
+        }
+        Dados &dados = m();
+        dados.viData.clear();
+        dados.vdData.clear();
+        dados.vbData.clear();
+        dados.vOffsets.assign(1, 0);
+        dados.strBytes.clear();
+        dados.viCodigos.clear();
+    }
+
+    // Acesso direto aos buffers contíguos (para varreduras tipadas)
+    const pmr::vector<int64_t> &intData() const { return d().viData; }
+    const pmr::vector<double> &doubleData() const { return d().vdData; }
+    const pmr::vector<uint8_t> &boolData() const { return d().vbData; }
+    const pmr::vector<uint32_t> &codeData() const { return d().viCodigos; }
+    const shared_ptr<StringInterner> &dictionary() const { return pDicionario; }
+
+    // Inserções tipadas, sem passar por std::any
+    void appendInt(int64_t valor) { m().viData.push_back(valor); }
+    void appendDouble(double valor) { m().vdData.push_back(valor); }
+    void appendBool(bool valor) { m().vbData.push_back(valor ? 1 : 0); }
+    void appendString(string_view valor)
+    {
+        if (isDictionary())
+        {
+            m().viCodigos.push_back(pDicionario->codigo(valor));
+            return;
+        }
+        Dados &dados = m();
+        dados.strBytes.append(valor.data(), valor.size());
+        dados.vOffsets.push_back(dados.strBytes.size());
+    }
+    void appendCode(uint32_t codigo) { m().viCodigos.push_back(codigo); }
+
+    // Leituras tipadas (o chamador garante o tipo da coluna)
+    int64_t getInt(size_t i) const { return d().viData[i]; }
+    double getDouble(size_t i) const { return d().vdData[i]; }
+    bool getBool(size_t i) const { return d().vbData[i] != 0; }
+    uint32_t getCode(size_t i) const { return d().viCodigos[i]; }
+    string_view getString(size_t i) const
+    {
+        if (isDictionary())
+            return pDicionario->texto(d().viCodigos[i]);
+        return string_view(d().strBytes.data() + d().vOffsets[i], d().vOffsets[i + 1] - d().vOffsets[i]);
+    }
+
+    /**
+     * @brief Retorna o valor da linha i formatado como string (mesmo formato de anyToString).
+     * @param i Índice da linha.
+     */
+    string getAsString(size_t i) const
+    {
+        if (isInt())
+            return to_string(d().viData[i]);
+        if (isDouble())
+            return to_string(d().vdData[i]);
+        if (isBool())
+            return d().vbData[i] ? "true" : "false";
+        return string(getString(i));
+    }
+
+    /**
+     * @brief Retorna o valor da linha i convertido para double.
+     * @param i Índice da linha.
+     * @throw invalid_argument Se uma string não puder ser convertida.
+     */
+    double getAsDouble(size_t i) const
+    {
+        if (isInt())
+            return static_cast<double>(d().viData[i]);
+        if (isDouble())
+            return d().vdData[i];
+        if (isBool())
+            return d().vbData[i];
+        return stod(string(getString(i)));
+    }
+
+    /**
+     * @brief Copia a coluna para um vetor contíguo de double (base dos kernels de agregação).
+     *
+     * Strings que não representam números viram 0.0, como na agregação por strings.
+     * @return Vetor com um valor por linha.
+     */
+    vector<double> toDoubleVector() const
+    {
+        size_t n = iGetSize();
+        if (isDouble())
+            return vector<double>(d().vdData.begin(), d().vdData.end());
+
+        vector<double> vdValores(n);
+        if (isInt())
+        {
+            for (size_t i = 0; i < n; i++)
+                vdValores[i] = static_cast<double>(d().viData[i]);
+        }
+        else if (isBool())
+        {
+            for (size_t i = 0; i < n; i++)
+                vdValores[i] = d().vbData[i];
+        }
+        else
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                string_view valor = getString(i);
+                auto [fim, erro] = from_chars(valor.data(), valor.data() + valor.size(), vdValores[i]);
+                if (erro != errc() || fim != valor.data() + valor.size())
+                {
+                    // Formatos que from_chars não aceita (espaços, '+', sufixos) caem no stod
+                    try
+                    {
+                        vdValores[i] = stod(string(valor));
+                    }
+                    catch (const exception &)
+                    {
+                        vdValores[i] = 0.0;
+                    }
+                }
+            }
+        }
+        return vdValores;
+    }
+
+    /**
+     * @brief Combina o hash de 64 bits de cada linha desta coluna em vHashes.
+     *
+     * Usado para montar chaves compostas de agrupamento coluna a coluna, sem
+     * concatenar strings.
+     * @param vHashes Vetor com um hash por linha (deve ter o tamanho da coluna).
+     */
+    void combinaHash(vector<uint64_t> &vHashes) const
+    {
+        auto mistura = [](uint64_t h, uint64_t x)
+        {
+            h ^= x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            return h;
+        };
+
+        size_t n = iGetSize();
+        if (isInt())
+        {
+            for (size_t i = 0; i < n; i++)
+                vHashes[i] = mistura(vHashes[i], static_cast<uint64_t>(d().viData[i]));
+        }
+        else if (isDouble())
+        {
+            for (size_t i = 0; i < n; i++)
+                vHashes[i] = mistura(vHashes[i], hash<double>{}(d().vdData[i]));
+        }
+        else if (isBool())
+        {
+            for (size_t i = 0; i < n; i++)
+                vHashes[i] = mistura(vHashes[i], d().vbData[i]);
+        }
+        else if (isDictionary())
+        {
+            // O hash de cada código já foi calculado pelo dicionário (igual ao de uma string comum)
+            for (size_t i = 0; i < n; i++)
+                vHashes[i] = mistura(vHashes[i], pDicionario->hashDe(d().viCodigos[i]));
+        }
+        else
+        {
+            hash<string_view> hasher;
+            for (size_t i = 0; i < n; i++)
+                vHashes[i] = mistura(vHashes[i], hasher(getString(i)));
+        }
+    }
+
+    /**
+     * @brief Compara os valores de duas linhas desta coluna.
+     * @param i Índice da primeira linha.
+     * @param j Índice da segunda linha.
+     * @return true se os valores forem iguais.
+     */
+    bool bLinhasIguais(size_t i, size_t j) const
+    {
+        if (isInt())
+            return d().viData[i] == d().viData[j];
+        if (isDouble())
+            return d().vdData[i] == d().vdData[j];
+        if (isBool())
+            return d().vbData[i] == d().vbData[j];
+        if (isDictionary())
+            return d().viCodigos[i] == d().viCodigos[j];
+        return getString(i) == getString(j);
+    }
+
+    /**
+     * @brief Compara o valor da linha i desta coluna com a linha j de outra coluna.
+     * @param i Índice da linha nesta coluna.
+     * @param other Coluna a comparar (se o tipo for diferente, compara como string).
+     * @param j Índice da linha na outra coluna.
+     * @return true se os valores forem iguais.
+     */
+    bool bValorIgual(size_t i, const Column &other, size_t j) const
+    {
+        if (other.strColumnType != strColumnType)
+            return getAsString(i) == other.getAsString(j);
+        if (isInt())
+            return d().viData[i] == other.d().viData[j];
+        if (isDouble())
+            return d().vdData[i] == other.d().vdData[j];
+        if (isBool())
+            return d().vbData[i] == other.d().vbData[j];
+        if (bMesmoDicionario(other))
+            return d().viCodigos[i] == other.d().viCodigos[j];
+        return getString(i) == other.getString(j);
+    }
+
+    /**
+     * @brief Adiciona um campo de texto, convertendo-o diretamente para o tipo da coluna.
+     *
+     * Inteiros e reais são lidos com from_chars (o campo inteiro deve ser um número);
+     * booleanos aceitam "true"/"false"/"1"/"0" sem diferenciar maiúsculas.
+     * @param valor Texto do campo.
+     * @return true se o campo for válido para o tipo da coluna (se não for, nada é inserido).
+     */
+    bool bAdicionaTexto(string_view valor)
+    {
+        const char *inicio = valor.data();
+        const char *fim = valor.data() + valor.size();
+        if (isInt())
+        {
+            int64_t v;
+            auto [ptr, erro] = from_chars(inicio, fim, v);
+            if (erro != errc() || ptr != fim)
+                return false;
+            m().viData.push_back(v);
+        }
+        else if (isDouble())
+        {
+            double v;
+            auto [ptr, erro] = from_chars(inicio, fim, v);
+            if (erro != errc() || ptr != fim)
+                return false;
+            m().vdData.push_back(v);
+        }
+        else if (isBool())
+        {
+            int iValor = iLeBool(valor);
+            if (iValor < 0)
+                return false;
+            m().vbData.push_back(static_cast<uint8_t>(iValor));
+        }
+        else
+        {
+            appendString(valor);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Retorna o tipo mais restrito que representa um campo de texto.
+     * @param valor Texto do campo.
+     * @return "int", "double", "bool" ou "string".
+     */
+    static string strInfereTipo(string_view valor)
+    {
+        const char *inicio = valor.data();
+        const char *fim = valor.data() + valor.size();
+        int64_t i;
+        auto [fimInt, erroInt] = from_chars(inicio, fim, i);
+        if (erroInt == errc() && fimInt == fim)
+            return "int";
+        double d;
+        auto [fimDouble, erroDouble] = from_chars(inicio, fim, d);
+        if (erroDouble == errc() && fimDouble == fim)
+            return "double";
+        if (iLeBool(valor) >= 0)
+            return "bool";
+        return "string";
+    }
+
+    /**
+     * @brief Retorna o menor tipo que comporta os dois tipos informados ("" é o tipo neutro).
+     */
+    static string strUneTipos(const string &a, const string &b)
+    {
+        if (a.empty() || a == b)
+            return b;
+        if (b.empty())
+            return a;
+        if ((a == "int" && b == "double") || (a == "double" && b == "int"))
+            return "double";
+        return "string";
+    }
+
+    /**
+     * @brief Adiciona um elemento std::any, convertendo-o para o tipo da coluna.
+     * @param elemento Elemento a ser adicionado.
+     * @return true se a conversão e a inserção forem bem-sucedidas, false caso contrário.
+     */
+    bool bAdicionaElemento(const any &elemento)
+    {
+        try
+        {
+            const type_info &tipo = elemento.type();
+            if (isString())
+            {
+                if (tipo == typeid(string))
+                    appendString(any_cast<const string &>(elemento));
+                else
+                    appendString(anyToString(elemento));
+            }
+            else if (isInt())
+            {
+                if (tipo == typeid(int64_t))
+                    appendInt(any_cast<int64_t>(elemento));
+                else if (tipo == typeid(int))
+                    appendInt(any_cast<int>(elemento));
+                else if (tipo == typeid(double))
+                    appendInt(static_cast<int64_t>(any_cast<double>(elemento)));
+                else if (tipo == typeid(bool))
+                    appendInt(any_cast<bool>(elemento) ? 1 : 0);
+                else
+                    appendInt(stoll(anyToString(elemento)));
+            }
+            else if (isDouble())
+            {
+                if (tipo == typeid(double))
+                    appendDouble(any_cast<double>(elemento));
+                else if (tipo == typeid(int64_t))
+                    appendDouble(static_cast<double>(any_cast<int64_t>(elemento)));
+                else if (tipo == typeid(int))
+                    appendDouble(any_cast<int>(elemento));
+                else
+                    appendDouble(stod(anyToString(elemento)));
+            }
+            else
+            {
+                if (tipo == typeid(bool))
+                    appendBool(any_cast<bool>(elemento));
+                else if (tipo == typeid(int))
+                    appendBool(any_cast<int>(elemento) != 0);
+                else if (tipo == typeid(int64_t))
+                    appendBool(any_cast<int64_t>(elemento) != 0);
+                else
+                {
+                    string s = anyToString(elemento);
+                    transform(s.begin(), s.end(), s.begin(), ::tolower);
+                    if (s == "true" || s == "1")
+                        appendBool(true);
+                    else if (s == "false" || s == "0")
+                        appendBool(false);
+                    else
+                        return false;
+                }
+            }
+        }
+        catch (const exception &)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Copia o elemento da linha i de outra coluna do mesmo tipo para o fim desta.
+     * @param other Coluna de origem.
+     * @param i Índice da linha na coluna de origem.
+     */
+    void appendFrom(const Column &other, size_t i)
+    {
+        if (other.strColumnType != strColumnType)
+        {
+            bAdicionaElemento(other.retornaElemento(i));
+        }
+        else if (isInt())
+            m().viData.push_back(other.d().viData[i]);
+        else if (isDouble())
+            m().vdData.push_back(other.d().vdData[i]);
+        else if (isBool())
+            m().vbData.push_back(other.d().vbData[i]);
+        else if (bMesmoDicionario(other))
+            m().viCodigos.push_back(other.d().viCodigos[i]);
+        else
+            appendString(other.getString(i));
+    }
+
+    /**
+     * @brief Remove o último elemento da coluna.
+     * @return true se a remoção for bem-sucedida, false caso contrário.
+     */
+    bool bRemoveUltimoElemento()
+    {
+        size_t n = iGetSize();
+        if (n == 0)
+            return false;
+        if (isInt())
+            m().viData.pop_back();
+        else if (isDouble())
+            m().vdData.pop_back();
+        else if (isBool())
+            m().vbData.pop_back();
+        else if (isDictionary())
+            m().viCodigos.pop_back();
+        else
+        {
+            Dados &dados = m();
+            dados.vOffsets.pop_back();
+            dados.strBytes.resize(dados.vOffsets.back());
+        }
+        return true;
+    }
+
+    /**
+     * @brief Remove um elemento da coluna com base no índice.
+     * @param iIndex O índice do elemento que deve ser removido.
+     * @return true se a remoção for bem-sucedida, false caso contrário.
+     */
+    bool bRemovePeloIndex(int iIndex)
+    {
+        if (iIndex < 0 || iIndex >= static_cast<int>(iGetSize()))
+            return false;
+
+        if (isInt())
+            m().viData.erase(m().viData.begin() + iIndex);
+        else if (isDouble())
+            m().vdData.erase(m().vdData.begin() + iIndex);
+        else if (isBool())
+            m().vbData.erase(m().vbData.begin() + iIndex);
+        else if (isDictionary())
+            m().viCodigos.erase(m().viCodigos.begin() + iIndex);
+        else
+        {
+            Dados &dados = m();
+            size_t inicio = dados.vOffsets[iIndex];
+            size_t tamanho = dados.vOffsets[iIndex + 1] - inicio;
+            dados.strBytes.erase(inicio, tamanho);
+            dados.vOffsets.erase(dados.vOffsets.begin() + iIndex + 1);
+            for (size_t k = iIndex + 1; k < dados.vOffsets.size(); k++)
+                dados.vOffsets[k] -= tamanho;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Retorna um elemento da coluna encapsulado em std::any.
+     * @param iIndex Índice do elemento.
+     * @return Elemento (int64_t, double, bool ou string).
+     * @throw out_of_range Se o índice for inválido.
+     */
+    any retornaElemento(int iIndex) const
+    {
+        if (iIndex < 0 || iIndex >= static_cast<int>(iGetSize()))
+            throw out_of_range("Índice fora dos limites: " + to_string(iIndex));
+
+        if (isInt())
+            return d().viData[iIndex];
+        if (isDouble())
+            return d().vdData[iIndex];
+        if (isBool())
+            return d().vbData[iIndex] != 0;
+        return string(getString(iIndex));
+    }
+
+    /**
+     * @brief Empilha os dados de outra coluna ao final desta.
+     * @param other A outra coluna a ser empilhada.
+     */
+    void hStack(const Column &other)
+    {
+        if (other.strColumnType != strColumnType ||
+            ((isDictionary() || other.isDictionary()) && !bMesmoDicionario(other)))
+        {
+            for (size_t i = 0; i < other.iGetSize(); i++)
+                appendFrom(other, i);
+            return;
+        }
+
+        // Colunas vazias passam a compartilhar os buffers da outra, sem cópia
+        if (iGetSize() == 0 && other.pDados)
+        {
+            pDados = other.pDados;
+            return;
+        }
+
+        Dados &dados = m();
+        const Dados &outros = other.d();
+        if (isInt())
+            dados.viData.insert(dados.viData.end(), outros.viData.begin(), outros.viData.end());
+        else if (isDouble())
+            dados.vdData.insert(dados.vdData.end(), outros.vdData.begin(), outros.vdData.end());
+        else if (isBool())
+            dados.vbData.insert(dados.vbData.end(), outros.vbData.begin(), outros.vbData.end());
+        else if (isDictionary())
+            dados.viCodigos.insert(dados.viCodigos.end(), outros.viCodigos.begin(), outros.viCodigos.end());
+        else
+        {
+            size_t base = dados.strBytes.size();
+            dados.strBytes += outros.strBytes;
+            dados.vOffsets.reserve(dados.vOffsets.size() + outros.vOffsets.size() - 1);
+            for (size_t k = 1; k < outros.vOffsets.size(); k++)
+                dados.vOffsets.push_back(base + outros.vOffsets[k]);
+        }
+    }
+
+    /**
+     * @brief Cria uma nova coluna com as linhas indicadas, na ordem dada.
+     * @param vIndices Índices das linhas a copiar.
+     * @return Nova coluna com os elementos selecionados.
+     */
+    Column gather(const vector<size_t> &vIndices) const
+    {
+        Column resultado(strColumnName, strColumnType);
+        resultado.pDicionario = pDicionario;
+        if (isString() && !isDictionary())
+        {
+            resultado.reserve(vIndices.size());
+            for (size_t i : vIndices)
+                resultado.appendString(getString(i));
+            return resultado;
+        }
+
+        const Dados &origem = d();
+        Dados &destino = resultado.m();
+        if (isInt())
+        {
+            destino.viData.resize(vIndices.size());
+            for (size_t k = 0; k < vIndices.size(); k++)
+                destino.viData[k] = origem.viData[vIndices[k]];
+        }
+        else if (isDouble())
+        {
+            destino.vdData.resize(vIndices.size());
+            for (size_t k = 0; k < vIndices.size(); k++)
+                destino.vdData[k] = origem.vdData[vIndices[k]];
+        }
+        else if (isBool())
+        {
+            destino.vbData.resize(vIndices.size());
+            for (size_t k = 0; k < vIndices.size(); k++)
+                destino.vbData[k] = origem.vbData[vIndices[k]];
+        }
+        else
+        {
+            destino.viCodigos.resize(vIndices.size());
+            for (size_t k = 0; k < vIndices.size(); k++)
+                destino.viCodigos[k] = origem.viCodigos[vIndices[k]];
+        }
+        return resultado;
+    }
+
+    /**
+     * @brief Retorna um slice da coluna entre 'start' (inclusivo) e 'end' (exclusivo).
+     * @param start Índice inicial do slice.
+     * @param end Índice final do slice.
+     * @return Uma nova coluna contendo o slice dos dados.
+     */
+    Column slice(int start, int end) const
+    {
+        if (start < 0 || end > static_cast<int>(iGetSize()) || start >= end)
+        {
+            throw std::invalid_argument("Intervalo inválido para slice na coluna.");
+        }
+
+        Column resultado(strColumnName, strColumnType);
+        resultado.pDicionario = pDicionario;
+        if (isInt())
+            resultado.m().viData.assign(d().viData.begin() + start, d().viData.begin() + end);
+        else if (isDouble())
+            resultado.m().vdData.assign(d().vdData.begin() + start, d().vdData.begin() + end);
+        else if (isBool())
+            resultado.m().vbData.assign(d().vbData.begin() + start, d().vbData.begin() + end);
+        else if (isDictionary())
+            resultado.m().viCodigos.assign(d().viCodigos.begin() + start, d().viCodigos.begin() + end);
+        else
+        {
+            size_t base = d().vOffsets[start];
+            resultado.m().strBytes.assign(d().strBytes, base, d().vOffsets[end] - base);
+            resultado.m().vOffsets.reserve(end - start + 1);
+            for (int k = start + 1; k <= end; k++)
+                resultado.m().vOffsets.push_back(d().vOffsets[k] - base);
+        }
+        return resultado;
+    }
+
+    /**
+     * @brief Converte a coluna para outro tipo.
+     * @param strTipo Novo tipo ("int", "double", "bool" ou "string").
+     * @return Nova coluna com os valores convertidos.
+     * @throw invalid_argument Se algum valor não puder ser convertido.
+     */
+    Column convertTo(const string &strTipo) const
+    {
+        if (strTipo != "int" && strTipo != "double" && strTipo != "bool" && strTipo != "string")
+        {
+            throw invalid_argument("Tipo inválido: " + strTipo);
+        }
+
+        Column resultado(strColumnName, strTipo);
+        if (strTipo == strColumnType)
+        {
+            resultado = *this;
+            return resultado;
+        }
+
+        size_t n = iGetSize();
+        resultado.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!resultado.bAdicionaElemento(retornaElemento(i)))
+            {
+                throw invalid_argument("Erro ao converter valor '" + getAsString(i) + "' para " + strTipo);
+            }
+        }
+        return resultado;
+    }
+
+    /**
+     * @brief Sobrecarga do operador de inserção para exibir a coluna.
+     * @param os Fluxo de saída.
+     * @param coluna Coluna a ser exibida.
+     * @return Fluxo de saída atualizado.
+     */
+    friend ostream &operator<<(ostream &os, const Column &coluna)
+    {
+        os << coluna.strColumnName << " <" << coluna.strColumnType << ">: [";
+
+        size_t limit = min(coluna.iGetSize(), static_cast<size_t>(5));
+        for (size_t i = 0; i < limit; ++i)
+        {
+            os << coluna.getAsString(i);
+            if (i < limit - 1)
+                os << ", ";
+        }
+        if (coluna.iGetSize() > 5)
+            os << ", ...";
+        os << "]\n";
+
+        return os;
+    }
+};
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef CSV_TOKENIZER_H
+#define CSV_TOKENIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @class CsvTokenizer
+ * @brief Tokenizador de CSV em uma única passada, sem cópias por célula.
+ *
+ * Percorre o bloco de texto procurando ',' e '\n' com memchr (vetorizado pela libc)
+ * e entrega a cada linha um vetor de string_view apontando diretamente para o bloco.
+ * Campos entre aspas são suportados (inclusive com vírgulas, quebras de linha e
+ * aspas duplicadas ""); apenas esses campos escapados são copiados para um buffer
+ * auxiliar reaproveitado entre as linhas. Finais de linha "\r\n" também são aceitos.
+ */
+class CsvTokenizer
+{
+private:
+    /// Campo escapado, cujo conteúdo está em strEscapados
+    struct CampoEscapado
+    {
+        size_t iCampo;   ///< Índice do campo na linha
+        size_t iOffset;  ///< Início do conteúdo em strEscapados
+        size_t iTamanho; ///< Tamanho do conteúdo
+    };
+
+    vector<string_view> vCampos;          ///< Campos da linha atual
+    vector<CampoEscapado> vEscapados;     ///< Campos escapados da linha atual
+    string strEscapados;                  ///< Buffer com o conteúdo dos campos que tinham aspas duplicadas
+
+    /**
+     * @brief Lê um campo entre aspas a partir de p (que aponta para a aspa inicial).
+     * @return Ponteiro para o primeiro caractere após a aspa final.
+     */
+    const char *lerCampoComAspas(const char *p, const char *fim)
+    {
+        const char *inicio = ++p;
+        size_t offsetEscapado = string::npos;
+
+        while (true)
+        {
+            const char *aspa = static_cast<const char *>(memchr(p, '"', fim - p));
+            if (!aspa)
+            {
+                // Aspas não fechadas: o campo vai até o fim do bloco
+                aspa = fim;
+            }
+
+            bool duplicada = (aspa + 1 < fim && aspa[1] == '"');
+            if (duplicada || offsetEscapado != string::npos)
+            {
+                if (offsetEscapado == string::npos)
+                {
+                    offsetEscapado = strEscapados.size();
+                }
+                strEscapados.append(p, aspa - p);
+            }
+
+            if (duplicada)
+            {
+                strEscapados.push_back('"');
+                p = aspa + 2;
+                continue;
+            }
+
+            if (offsetEscapado == string::npos)
+            {
+                vCampos.emplace_back(inicio, aspa - inicio);
+            }
+            else
+            {
+                // O conteúdo real fica no buffer auxiliar, que ainda pode ser realocado: guarda
+                // só a posição e deixa uma view vazia no lugar, montada ao fim da linha
+                vEscapados.push_back({vCampos.size(), offsetEscapado, strEscapados.size() - offsetEscapado});
+                vCampos.emplace_back();
+            }
+            return aspa < fim ? aspa + 1 : fim;
+        }
+    }
+
+public:
+    /**
+     * @brief Percorre o bloco e chama onLinha(const vector<string_view>&) para cada linha não vazia.
+     * @param strBloco Bloco de texto CSV (sem cabeçalho).
+     * @param onLinha Função chamada com os campos de cada linha.
+     * @return Número de linhas entregues.
+     */
+    template <typename F>
+    size_t parse(string_view strBloco, F &&onLinha)
+    {
+        const char *p = strBloco.data();
+        const char *fim = p + strBloco.size();
+        size_t iLinhas = 0;
+
+        while (p < fim)
+        {
+            vCampos.clear();
+            vEscapados.clear();
+            strEscapados.clear();
+
+            const char *fimLinha = static_cast<const char *>(memchr(p, '\n', fim - p));
+            if (!fimLinha)
+                fimLinha = fim;
+
+            while (true)
+            {
+                const char *proximo;
+                if (p < fimLinha && *p == '"')
+                {
+                    p = lerCampoComAspas(p, fim);
+                    // Um campo com aspas pode conter '\n': recalcula o fim da linha
+                    if (p > fimLinha)
+                    {
+                        fimLinha = static_cast<const char *>(memchr(p, '\n', fim - p));
+                        if (!fimLinha)
+                            fimLinha = fim;
+                    }
+                    // Ignora qualquer lixo até o próximo separador
+                    proximo = static_cast<const char *>(memchr(p, ',', fimLinha - p));
+                    if (!proximo)
+                        proximo = fimLinha;
+                }
+                else
+                {
+                    proximo = static_cast<const char *>(memchr(p, ',', fimLinha - p));
+                    if (!proximo)
+                        proximo = fimLinha;
+                    vCampos.emplace_back(p, proximo - p);
+                }
+
+                if (proximo == fimLinha)
+                    break;
+                p = proximo + 1;
+            }
+
+            // Remove o '\r' de finais de linha no formato "\r\n" (campos escapados ainda estão vazios)
+            string_view &ultimo = vCampos.back();
+            if (!ultimo.empty() && ultimo.back() == '\r')
+            {
+                ultimo.remove_suffix(1);
+            }
+
+            for (const CampoEscapado &campo : vEscapados)
+            {
+                vCampos[campo.iCampo] = string_view(strEscapados.data() + campo.iOffset, campo.iTamanho);
+            }
+
+            p = fimLinha < fim ? fimLinha + 1 : fim;
+
+            // Linhas vazias são ignoradas
+            if (vCampos.size() == 1 && vCampos[0].empty())
+                continue;
+
+            onLinha(static_cast<const vector<string_view> &>(vCampos));
+            iLinhas++;
+        }
+
+        return iLinhas;
+    }
+
+    /**
+     * @brief Separa uma única linha (por exemplo, o cabeçalho) em campos.
+     * @param strLinha Linha CSV.
+     * @return Vetor com os campos como strings.
+     */
+    static vector<string> splitLinha(string_view strLinha)
+    {
+        CsvTokenizer tokenizer;
+        vector<string> vstrCampos;
+        tokenizer.parse(strLinha, [&](const vector<string_view> &campos)
+                        {
+            if (vstrCampos.empty())
+            {
+                vstrCampos.assign(campos.begin(), campos.end());
+            } });
+        return vstrCampos;
+    }
+};
+
+#endif
@@ -9,55 +9,28 @@
 #include <any>
 #include <unordered_map>
 #include <functional>
+#include <limits>
+#include <algorithm>
 #include "Series.h"
+#include "Column.h"
+#include "Expression.h"
+#include "Predicate.h"
 
 using namespace std;
 
-/**
- * @brief Converte um valor do tipo std::any para string.
- * @param value Valor a ser convertido.
- * @return String representando o valor ou mensagem de erro se falhar.
- */
-static inline string anyToString(const any &value)
-{
-    try
-    {
-        if (value.type() == typeid(string))
-        {
-            return any_cast<string>(value);
-        }
-        else if (value.type() == typeid(bool))
-        {
-            return any_cast<bool>(value) ? "true" : "false";
-        }
-        else if (value.type() == typeid(int))
-        {
-            return to_string(any_cast<int>(value));
-        }
-        else if (value.type() == typeid(double))
-        {
-            return to_string(any_cast<double>(value));
-        }
-        else
-        {
-            return "[Unsupported Type]";
-        }
-    }
-    catch (const bad_any_cast &)
-    {
-        return "[Error]";
-    }
-}
-
 /**
  * @class Dataframe
- * @brief Representa um conjunto de colunas (Series) organizadas como um DataFrame.
+ * @brief Representa um conjunto de colunas organizadas como um DataFrame.
+ *
+ * As colunas são armazenadas de forma tipada e contígua (ver Column), e não como
+ * Series<any>, evitando uma alocação no heap por célula.
  */
 class Dataframe
 {
 public:
     vector<string> vstrColumnsName; ///< Vetor que armazena os nomes das colunas
-    vector<Series<any>> columns;    ///< Vetor que armazena as colunas do DataFrame
+    vector<Column> columns;         ///< Vetor que armazena as colunas do DataFrame
+    shared_ptr<const Selecao> pSelecao; ///< Linhas selecionadas por filtra() ainda não compactadas (nulo = todas)
 
     /**
      * @brief Construtor padrão do DataFrame.
@@ -66,12 +39,16 @@ public:
 
     /**
      * @brief Construtor de cópia do DataFrame.
+     *
+     * As colunas da cópia compartilham os buffers das originais até que uma delas seja
+     * alterada (ver Column), então copiar um DataFrame custa O(número de colunas).
      * @param other Objeto Dataframe a ser copiado.
      */
     Dataframe(const Dataframe &other)
     {
         vstrColumnsName = other.vstrColumnsName;
         columns = other.columns;
+        pSelecao = other.pSelecao;
     }
 
     /**
@@ -82,6 +59,7 @@ public:
     {
         vstrColumnsName = std::move(other.vstrColumnsName);
         columns = std::move(other.columns);
+        pSelecao = std::move(other.pSelecao);
     }
 
     /**
@@ -95,6 +73,7 @@ public:
         {
             vstrColumnsName = other.vstrColumnsName;
             columns = other.columns;
+            pSelecao = other.pSelecao;
         }
         return *this;
     }
@@ -110,22 +89,23 @@ public:
         {
             vstrColumnsName = std::move(other.vstrColumnsName);
             columns = std::move(other.columns);
+            pSelecao = std::move(other.pSelecao);
         }
         return *this;
     }
 
     /**
-     * @brief Adiciona uma nova coluna (Series) ao DataFrame.
-     * @param novaSerie Objeto Series a ser adicionado.
+     * @brief Adiciona uma nova coluna ao DataFrame.
+     * @param novaColuna Coluna a ser adicionada.
      * @return true se a adição for bem-sucedida, false caso contrário.
      */
-    bool adicionaColuna(Series<any> novaSerie)
+    bool adicionaColuna(Column novaColuna)
     {
 
         if (columns.empty())
         {
-            vstrColumnsName.push_back(novaSerie.strGetName());
-            columns.push_back(novaSerie);
+            vstrColumnsName.push_back(novaColuna.strGetName());
+            columns.push_back(std::move(novaColuna));
             return true;
         }
         else
@@ -134,7 +114,7 @@ public:
 
             for (size_t i = 0; i < columns.size(); i++)
             {
-                if (novaSerie.iGetSize() != columns[i].iGetSize())
+                if (novaColuna.iGetSize() != columns[i].iGetSize())
                 {
                     viavel = false;
                     break;
@@ -143,8 +123,8 @@ public:
 
             if (viavel)
             {
-                vstrColumnsName.push_back(novaSerie.strGetName());
-                columns.push_back(novaSerie);
+                vstrColumnsName.push_back(novaColuna.strGetName());
+                columns.push_back(std::move(novaColuna));
                 return true;
             }
             else
@@ -177,23 +157,16 @@ public:
     template <typename T>
     bool adicionaColuna(const Series<T> &novaSerie)
     {
-        // Converter Series<T> para Series<any>
-        Series<any> serieConvertida(novaSerie.strGetName(), novaSerie.strGetType());
-
-        for (size_t i = 0; i < novaSerie.iGetSize(); i++)
+        // Converter Series<T> para a coluna tipada
+        try
         {
-            try
-            {
-                serieConvertida.bAdicionaElemento(novaSerie.retornaElemento(i));
-            }
-            catch (const exception &e)
-            {
-                cerr << "Erro ao converter elemento: " << e.what() << endl;
-                return false;
-            }
+            return adicionaColuna(Column::fromSeries(novaSerie));
+        }
+        catch (const exception &e)
+        {
+            cerr << "Erro ao converter elemento: " << e.what() << endl;
+            return false;
         }
-
-        return adicionaColuna(serieConvertida);
     }
 
     /**
@@ -231,31 +204,20 @@ public:
 
         for (size_t i = 0; i < columns.size(); i++)
         {
-            string expectedType = columns[i].strGetType();
-            bool valid = true;
-            try
+            bool valid = !(novaLinha[i].type() == typeid(string) && any_cast<const string &>(novaLinha[i]).empty());
+
+            // Converte o valor para o tipo da coluna; em caso de falha desfaz as colunas já preenchidas
+            if (!valid || !columns[i].bAdicionaElemento(novaLinha[i]))
             {
-                if (anyToString(novaLinha[i]).empty())
+                for (size_t k = 0; k < i; k++)
                 {
-                    valid = false;
+                    columns[k].bRemoveUltimoElemento();
                 }
-            }
-            catch (const bad_any_cast &)
-            {
-                valid = false;
-            }
-            if (!valid)
-            {
-                cerr << "Tipo de dado inválido para a coluna " << columns[i].strGetName() << ". Esperado: " << expectedType << endl;
+                cerr << "Tipo de dado inválido para a coluna " << columns[i].strGetName() << ". Esperado: " << columns[i].strGetType() << endl;
                 return false;
             }
         }
 
-        for (size_t i = 0; i < columns.size(); i++)
-        {
-            columns[i].bAdicionaElemento(novaLinha[i]);
-        }
-
         return true;
     }
 
@@ -288,68 +250,129 @@ public:
      */
     Dataframe filtroByValue(const string &strNomeColuna, const any &valor)
     {
+        Selecao selecao = seleciona(Predicado::igual(strNomeColuna, valor));
+
         Dataframe auxDf;
         auxDf.vstrColumnsName = vstrColumnsName;
 
-        // Criar estrutura das colunas no novo dataframe
+        // Copia os dados filtrados diretamente
+        vector<size_t> vIndices = selecao.indices();
         for (const auto &col : columns)
         {
-            auxDf.columns.emplace_back(col.strGetName(), col.strGetType());
+            auxDf.columns.push_back(col.gather(vIndices));
         }
 
-        // Localiza a coluna de filtro
-        auto it = find(vstrColumnsName.begin(), vstrColumnsName.end(), strNomeColuna);
-        if (it == vstrColumnsName.end())
-        {
-            throw std::invalid_argument("Coluna '" + strNomeColuna + "' não encontrada.");
-        }
+        return auxDf;
+    }
 
-        int colIndex = distance(vstrColumnsName.begin(), it);
-        const auto &data = columns[colIndex].getData();
+    /**
+     * @brief Avalia um predicado sobre todas as linhas, sem copiar dados.
+     * @param predicado Predicado a ser avaliado (ver Predicado).
+     * @return Bitmap das linhas que satisfazem o predicado (e a seleção atual, se houver).
+     */
+    Selecao seleciona(const Predicado &predicado) const
+    {
+        Selecao selecao = predicado.avaliar(vstrColumnsName, columns);
+        if (pSelecao)
+            selecao &= *pSelecao;
+        return selecao;
+    }
 
-        // Pré-conta quantas linhas irão para o novo DataFrame
-        size_t matchCount = count_if(data.begin(), data.end(), [&](const auto &el)
-                                     { return anyToString(el) == anyToString(valor); });
+    /**
+     * @brief Filtra o DataFrame em um único passo, guardando apenas a seleção das linhas.
+     *
+     * As colunas não são copiadas: operadores que sabem percorrer a seleção (ver temSelecao)
+     * leem só as linhas marcadas, e os demais chamam compacta() antes de usar o DataFrame.
+     * Filtros sucessivos são combinados com E.
+     * @param predicado Predicado a ser aplicado.
+     * @return Referência para o próprio DataFrame.
+     */
+    Dataframe &filtra(const Predicado &predicado)
+    {
+        pSelecao = make_shared<const Selecao>(seleciona(predicado));
+        return *this;
+    }
 
-        // Pré-aloca espaço nas colunas do novo dataframe
-        for (auto &col : auxDf.columns)
-        {
-            col.reserve(matchCount);
-        }
+    /**
+     * @brief Filtra o DataFrame com uma seleção já avaliada (ex.: por Predicado::avaliarJuntos).
+     *
+     * Como filtra(Predicado), só guarda a seleção, combinada com E com a atual.
+     * @param selecao Bitmap das linhas mantidas (com uma posição por linha do DataFrame).
+     * @return Referência para o próprio DataFrame.
+     */
+    Dataframe &filtra(Selecao selecao)
+    {
+        if (pSelecao)
+            selecao &= *pSelecao;
+        pSelecao = make_shared<const Selecao>(std::move(selecao));
+        return *this;
+    }
 
-        // Copia os dados filtrados diretamente
-        for (size_t i = 0; i < data.size(); ++i)
+    /**
+     * @brief Indica se o DataFrame tem uma seleção pendente de filtra().
+     */
+    bool temSelecao() const { return pSelecao != nullptr; }
+
+    /**
+     * @brief Retorna a seleção pendente (só válida se temSelecao()).
+     */
+    const Selecao &selecao() const { return *pSelecao; }
+
+    /**
+     * @brief Retorna o número de linhas selecionadas (todas, se não houver seleção).
+     */
+    size_t iLinhasSelecionadas() const
+    {
+        if (pSelecao)
+            return pSelecao->contagem();
+        return columns.empty() ? 0 : columns[0].iGetSize();
+    }
+
+    /**
+     * @brief Lacra as arenas das colunas (ver Column::lacraArena), ao entregar o batch.
+     */
+    void lacraArenas()
+    {
+        for (auto &coluna : columns)
+            coluna.lacraArena();
+    }
+
+    /**
+     * @brief Copia para as colunas apenas as linhas selecionadas e descarta a seleção.
+     */
+    void compacta()
+    {
+        if (!pSelecao)
+            return;
+        vector<size_t> vIndices = pSelecao->indices();
+        pSelecao.reset();
+        if (columns.empty() || vIndices.size() == columns[0].iGetSize())
+            return;
+        for (auto &col : columns)
         {
-            if (anyToString(data[i]) == anyToString(valor))
-            {
-                for (size_t j = 0; j < columns.size(); ++j)
-                {
-                    auxDf.columns[j].bAdicionaElemento(columns[j].retornaElemento(i));
-                }
-            }
+            col = col.gather(vIndices);
         }
-
-        return auxDf;
     }
 
     /**
      * @brief Empilha dois DataFrames horizontalmente.
      * @param other O DataFrame a ser empilhado.
+     * @return true se o DataFrame foi empilhado (false se os tamanhos ou os tipos forem diferentes).
      */
-    void hStack(Dataframe &other)
+    bool hStack(Dataframe &other)
     {
         if (this->columns.empty())
         {
             // Copia os nomes das colunas e os dados do outro DataFrame
             this->vstrColumnsName = other.vstrColumnsName;
             this->columns = other.columns;
-            return;
+            return true;
         }
 
         if (this->columns.size() != other.columns.size())
         {
             cout << "DataFrames com tamanhos diferentes. Não é possível empilhar." << endl;
-            return;
+            return false;
         }
 
         for (size_t i = 0; i < columns.size(); i++)
@@ -357,7 +380,7 @@ public:
             if (columns[i].strGetType() != other.columns[i].strGetType())
             {
                 cout << "Tipos de colunas diferentes. Não é possível empilhar." << endl;
-                return;
+                return false;
             }
         }
 
@@ -365,6 +388,7 @@ public:
         {
             columns[i].hStack(other.columns[i]);
         }
+        return true;
     }
 
     /**
@@ -387,9 +411,6 @@ public:
             throw invalid_argument("DataFrames têm números diferentes de colunas");
         }
 
-        // Mapa para armazenar as linhas por chave de agrupamento
-        unordered_map<string, vector<int>> groupMap;
-
         // Identifica colunas de grupo (não terminam com _sum, _mean ou count)
         vector<bool> isGroupColumn;
         for (const auto &colName : vstrColumnsName)
@@ -400,96 +421,240 @@ public:
             isGroupColumn.push_back(isGroup);
         }
 
-        // Criar chaves para as linhas existentes
-        for (int i = 0; i < getShape().first; ++i)
+        // Hash de 64 bits das colunas de grupo de cada linha, sem passar os valores para texto
+        auto hashesDe = [&](const Dataframe &df)
         {
-            string key;
-            for (size_t j = 0; j < vstrColumnsName.size(); ++j)
+            vector<uint64_t> hashes(df.getShape().first, 0);
+            for (size_t j = 0; j < df.columns.size(); ++j)
             {
                 if (isGroupColumn[j])
-                {
-                    key += anyToString(columns[j].retornaElemento(i)) + "|";
-                }
+                    df.columns[j].combinaHash(hashes);
             }
-            groupMap[key].push_back(i);
+            return hashes;
+        };
+
+        // Mapa do hash da chave para as linhas com esse hash neste DataFrame
+        int nLinhas = getShape().first;
+        unordered_multimap<uint64_t, int> groupMap;
+        groupMap.reserve(nLinhas + other.getShape().first);
+        vector<uint64_t> hashes = hashesDe(*this);
+        for (int i = 0; i < nLinhas; ++i)
+        {
+            groupMap.emplace(hashes[i], i);
         }
+        hashes = hashesDe(other);
+
+        // Somas acumuladas das linhas alteradas (as linhas não são removidas durante a junção,
+        // então os índices do mapa permanecem válidos). Colunas int somam em int64_t, sem passar
+        // por double; as demais somam em double
+        vector<vector<double>> somas(vstrColumnsName.size());
+        vector<vector<int64_t>> somasInt(vstrColumnsName.size());
+        auto inteiro = [](const Column &coluna, int r)
+        {
+            return coluna.isInt() ? coluna.getInt(r) : static_cast<int64_t>(coluna.getAsDouble(r));
+        };
+        // Inicia a soma de uma linha alterada com o valor da linha r de coluna
+        auto iniciaSoma = [&](size_t j, const Column &coluna, int r)
+        {
+            if (columns[j].isInt())
+                somasInt[j].push_back(inteiro(coluna, r));
+            else
+                somas[j].push_back(coluna.getAsDouble(r));
+        };
+        vector<int> linhaAlterada(nLinhas, -1);
+        int nAlteradas = 0;
+        vector<int> novasLinhas;
+
+        // Compara a chave da linha i do outro DataFrame com a do grupo idx (linha deste
+        // DataFrame ou, a partir de nLinhas, um novo grupo vindo do outro)
+        auto mesmaChave = [&](int idx, int i)
+        {
+            for (size_t j = 0; j < columns.size(); ++j)
+            {
+                if (!isGroupColumn[j])
+                    continue;
+                bool igual = idx < nLinhas ? columns[j].bValorIgual(idx, other.columns[j], i)
+                                           : other.columns[j].bLinhasIguais(novasLinhas[idx - nLinhas], i);
+                if (!igual)
+                    return false;
+            }
+            return true;
+        };
 
-        // Para cada linha do outro DataFrame
         for (int i = 0; i < other.getShape().first; ++i)
         {
-            string key;
-            vector<any> newRow;
+            int existingIdx = -1;
+            auto [inicio, fim] = groupMap.equal_range(hashes[i]);
+            for (auto it = inicio; it != fim && existingIdx < 0; ++it)
+            {
+                if (mesmaChave(it->second, i))
+                    existingIdx = it->second;
+            }
+            if (existingIdx < 0)
+            {
+                // Novo grupo: a linha do outro DataFrame é anexada ao final
+                groupMap.emplace(hashes[i], nLinhas + static_cast<int>(novasLinhas.size()));
+                novasLinhas.push_back(i);
+                continue;
+            }
 
-            // Constrói a chave para esta linha
-            for (size_t j = 0; j < other.vstrColumnsName.size(); ++j)
+            if (existingIdx >= nLinhas)
             {
-                if (isGroupColumn[j])
+                // Grupo repetido dentro do próprio outro DataFrame
+                int origem = novasLinhas[existingIdx - nLinhas];
+                if (linhaAlterada.size() <= static_cast<size_t>(existingIdx))
+                    linhaAlterada.resize(existingIdx + 1, -1);
+                if (linhaAlterada[existingIdx] < 0)
                 {
-                    key += anyToString(other.columns[j].retornaElemento(i)) + "|";
+                    linhaAlterada[existingIdx] = nAlteradas++;
+                    for (size_t j = 0; j < vstrColumnsName.size(); ++j)
+                        if (!isGroupColumn[j])
+                            iniciaSoma(j, other.columns[j], origem);
                 }
             }
-
-            auto existingGroup = groupMap.find(key);
-            if (existingGroup != groupMap.end())
+            else if (linhaAlterada[existingIdx] < 0)
             {
-                // Grupo existente - somar valores
-                int existingIdx = existingGroup->second[0];
+                linhaAlterada[existingIdx] = nAlteradas++;
                 for (size_t j = 0; j < vstrColumnsName.size(); ++j)
+                    if (!isGroupColumn[j])
+                        iniciaSoma(j, columns[j], existingIdx);
+            }
+
+            // Soma valores para colunas de agregação
+            int slot = linhaAlterada[existingIdx];
+            for (size_t j = 0; j < vstrColumnsName.size(); ++j)
+            {
+                if (!isGroupColumn[j])
                 {
-                    if (isGroupColumn[j])
-                    {
-                        // Mantém o valor original para colunas de grupo
-                        newRow.push_back(columns[j].retornaElemento(existingIdx));
-                    }
+                    if (columns[j].isInt())
+                        somasInt[j][slot] += inteiro(other.columns[j], i);
                     else
-                    {
-                        // Soma valores para colunas de agregação
-                        double val1 = stod(anyToString(columns[j].retornaElemento(existingIdx)));
-                        double val2 = stod(anyToString(other.columns[j].retornaElemento(i)));
-
-                        if (columns[j].strGetType() == "int")
-                            newRow.push_back(static_cast<int>(val1 + val2));
-                        else
-                            newRow.push_back(val1 + val2);
-                    }
+                        somas[j][slot] += other.columns[j].getAsDouble(i);
                 }
+            }
+        }
 
-                // Remove a linha antiga e adiciona a nova linha somada
-                removeLinha(existingIdx);
-                adicionaLinha(newRow);
+        // Reconstrói as colunas: linhas antigas (somadas ou não) seguidas dos novos grupos
+        int nTotal = nLinhas + static_cast<int>(novasLinhas.size());
+        linhaAlterada.resize(nTotal, -1);
+        for (size_t j = 0; j < columns.size(); ++j)
+        {
+            if (isGroupColumn[j])
+            {
+                for (int origem : novasLinhas)
+                {
+                    columns[j].appendFrom(other.columns[j], origem);
+                }
+                continue;
+            }
 
-                // Atualiza o índice no mapa
-                existingGroup->second[0] = getShape().first - 1;
+            Column nova(columns[j].strGetName(), columns[j].strGetType());
+            nova.reserve(nTotal);
+            for (int r = 0; r < nTotal; ++r)
+            {
+                int slot = linhaAlterada[r];
+                if (slot >= 0)
+                {
+                    if (nova.isInt())
+                        nova.appendInt(somasInt[j][slot]);
+                    else
+                        nova.bAdicionaElemento(somas[j][slot]);
+                }
+                else if (r < nLinhas)
+                {
+                    nova.appendFrom(columns[j], r);
+                }
+                else
+                {
+                    nova.appendFrom(other.columns[j], novasLinhas[r - nLinhas]);
+                }
             }
-            else
+            columns[j] = std::move(nova);
+        }
+    }
+
+    /**
+     * @brief Atribui a cada linha o identificador do seu grupo.
+     *
+     * A chave composta de cada linha é reduzida a um hash de 64 bits calculado coluna a
+     * coluna (Column::combinaHash); colisões de hash são resolvidas comparando os valores
+     * das colunas de agrupamento com a primeira linha de cada grupo.
+     * @param viIndexColunas Índices das colunas de agrupamento.
+     * @param viGrupoDaLinha Saída: identificador do grupo de cada linha.
+     * @return Índice da primeira linha de cada grupo (na ordem de aparição).
+     */
+    vector<size_t> vAtribuiGrupos(const vector<int> &viIndexColunas, vector<uint32_t> &viGrupoDaLinha) const
+    {
+        size_t numRows = columns.empty() ? 0 : columns[0].iGetSize();
+        vector<uint64_t> vHashes(numRows, 0);
+        for (int idx : viIndexColunas)
+        {
+            columns[idx].combinaHash(vHashes);
+        }
+
+        auto mesmaChave = [&](size_t i, size_t j)
+        {
+            for (int idx : viIndexColunas)
             {
-                // Novo grupo - adiciona a linha diretamente
-                for (size_t j = 0; j < other.vstrColumnsName.size(); ++j)
+                if (!columns[idx].bLinhasIguais(i, j))
+                    return false;
+            }
+            return true;
+        };
+
+        // Hash -> primeiro grupo com esse hash; grupos com o mesmo hash são encadeados
+        unordered_map<uint64_t, uint32_t> umapPrimeiroGrupo;
+        umapPrimeiroGrupo.reserve(64);
+        vector<size_t> viPrimeiraLinha;
+        vector<uint32_t> viProximoGrupo;
+        viGrupoDaLinha.resize(numRows);
+
+        for (size_t i = 0; i < numRows; ++i)
+        {
+            auto [it, novo] = umapPrimeiroGrupo.try_emplace(vHashes[i], static_cast<uint32_t>(viPrimeiraLinha.size()));
+            uint32_t g = it->second;
+            if (!novo)
+            {
+                // Percorre a cadeia de grupos com o mesmo hash
+                while (!mesmaChave(viPrimeiraLinha[g], i) && viProximoGrupo[g] != UINT32_MAX)
+                {
+                    g = viProximoGrupo[g];
+                }
+                if (!mesmaChave(viPrimeiraLinha[g], i))
                 {
-                    newRow.push_back(other.columns[j].retornaElemento(i));
+                    viProximoGrupo[g] = static_cast<uint32_t>(viPrimeiraLinha.size());
+                    novo = true;
                 }
-                adicionaLinha(newRow);
-                groupMap[key] = {getShape().first - 1};
             }
+            if (novo)
+            {
+                g = static_cast<uint32_t>(viPrimeiraLinha.size());
+                viPrimeiraLinha.push_back(i);
+                viProximoGrupo.push_back(UINT32_MAX);
+            }
+            viGrupoDaLinha[i] = g;
         }
+        return viPrimeiraLinha;
     }
 
     /**
-     * @brief Agrupa o DataFrame por uma coluna específica e aplica uma função de agregação.
+     * @brief Agrupa o DataFrame e aplica agregações tipadas sobre as colunas numéricas.
+     *
+     * Cada coluna agregada é lida uma vez como vetor contíguo e acumulada por grupo
+     * (soma, mínimo, máximo e contagem em acumuladores correntes; a variância usa uma
+     * segunda passada sobre os desvios em relação à média). Nenhum valor é guardado
+     * como string.
+     *
      * @param groupCols Colunas a serem usadas para agrupamento.
-     * @param vstrColumnsToAggregate Colunas a serem agregadas (se vazio, todas as colunas serão agregadas).
-     * @param soma Se true, realiza a soma das colunas agregadas.
-     * @param media Se true, realiza a média das colunas agregadas.
-     * @param contagem Se true, adiciona uma coluna de contagem.
-     * @return Um novo DataFrame com os dados agrupados e agregados.
+     * @param vAgregacoes Pares (coluna, operação), com operação "sum", "min", "max", "count", "mean" ou "var".
+     *        Uma coluna vazia com a operação "count" gera a contagem de linhas do grupo.
+     * @return DataFrame com as colunas de agrupamento seguidas de uma coluna "<coluna>_<operação>"
+     *         por agregação ("count" quando a coluna é vazia).
+     * @throw invalid_argument Se alguma coluna ou operação não existir.
      */
-    Dataframe dfGroupby(const vector<string> &groupCols, vector<string> vstrColumnsToAggregate = {}, bool soma = true, bool media = true, bool contagem = true)
+    Dataframe dfAgrega(const vector<string> &groupCols, const vector<pair<string, string>> &vAgregacoes) const
     {
-        Dataframe dfAgrupado;
-        vector<int> viIndexColumnsToAggregate;
         vector<int> viIndexColunasDeAgrupamento;
-
-        // Validação das colunas de agrupamento
         for (const auto &nomeCol : groupCols)
         {
             auto it = find(vstrColumnsName.begin(), vstrColumnsName.end(), nomeCol);
@@ -500,141 +665,170 @@ public:
             viIndexColunasDeAgrupamento.push_back(distance(vstrColumnsName.begin(), it));
         }
 
-        // Define as colunas a serem agregadas (se não especificadas)
-        if (vstrColumnsToAggregate.empty())
-        {
-            vstrColumnsToAggregate = vstrColumnsName;
-            for (const auto &nomeCol : groupCols)
-            {
-                vstrColumnsToAggregate.erase(remove(vstrColumnsToAggregate.begin(), vstrColumnsToAggregate.end(), nomeCol), vstrColumnsToAggregate.end());
-            }
-        }
+        vector<uint32_t> viGrupoDaLinha;
+        vector<size_t> viPrimeiraLinha = vAtribuiGrupos(viIndexColunasDeAgrupamento, viGrupoDaLinha);
+        size_t numGrupos = viPrimeiraLinha.size();
+        size_t numRows = viGrupoDaLinha.size();
 
-        // Salva os índices e tipos das colunas agregadas
-        vector<string> aggTypes;
-        for (const auto &col : vstrColumnsToAggregate)
+        // Contagem de linhas por grupo (compartilhada por count, mean e var)
+        vector<int64_t> viContagem(numGrupos, 0);
+        for (size_t i = 0; i < numRows; ++i)
         {
-            auto it = find(vstrColumnsName.begin(), vstrColumnsName.end(), col);
-            if (it == vstrColumnsName.end())
-            {
-                throw std::invalid_argument("Coluna de agregação '" + col + "' não encontrada.");
-            }
-            int idx = distance(vstrColumnsName.begin(), it);
-            viIndexColumnsToAggregate.push_back(idx);
-            aggTypes.push_back(columns[idx].strGetType());
+            viContagem[viGrupoDaLinha[i]]++;
         }
 
-        // Monta o DataFrame de saída
-        dfAgrupado.vstrColumnsName.clear();
-        // Colunas de agrupamento
+        Dataframe dfAgrupado;
+
+        // Colunas de agrupamento: o valor da primeira linha de cada grupo
+        vector<size_t> viPrimeiras(viPrimeiraLinha.begin(), viPrimeiraLinha.end());
         for (int idx : viIndexColunasDeAgrupamento)
         {
             dfAgrupado.vstrColumnsName.push_back(vstrColumnsName[idx]);
-            dfAgrupado.columns.emplace_back(vstrColumnsName[idx], columns[idx].strGetType());
-        }
-        // Colunas agregadas
-        for (size_t i = 0; i < vstrColumnsToAggregate.size(); i++)
-        {
-            if (soma)
-            {
-                dfAgrupado.vstrColumnsName.push_back(vstrColumnsToAggregate[i] + "_sum");
-                dfAgrupado.columns.emplace_back(vstrColumnsToAggregate[i] + "_sum", aggTypes[i]);
-            }
-            if (media)
-            {
-                string tipo = aggTypes[i];
-                if (tipo == "int")
-                    tipo = "double";
-                dfAgrupado.vstrColumnsName.push_back(vstrColumnsToAggregate[i] + "_mean");
-                dfAgrupado.columns.emplace_back(vstrColumnsToAggregate[i] + "_mean", tipo);
-            }
-        }
-        if (contagem)
-        {
-            dfAgrupado.vstrColumnsName.push_back("count");
-            dfAgrupado.columns.emplace_back("count", "string");
+            dfAgrupado.columns.push_back(columns[idx].gather(viPrimeiras));
         }
 
-        // Tabela hash: chave -> par (vetor com vetores dos valores agregados, valores dos agrupamentos)
-        unordered_map<string, pair<vector<vector<string>>, vector<string>>> umapGroupedData;
-        int numAggregateColumns = viIndexColumnsToAggregate.size();
-        int numRows = columns.empty() ? 0 : columns[0].getData().size();
+        // Vetores contíguos das colunas agregadas, convertidos uma única vez
+        unordered_map<int, vector<double>> umapValores;
 
-        for (int i = 0; i < numRows; ++i)
+        for (const auto &[strColuna, strOperacao] : vAgregacoes)
         {
-            // Cria a chave composta
-            string chave;
-            vector<string> valoresChave;
-            for (int idx : viIndexColunasDeAgrupamento)
-            {
-                string valor = anyToString(columns[idx].getData()[i]);
-                chave += valor + "|";
-                valoresChave.push_back(valor);
-            }
+            string strNome = strColuna.empty() ? strOperacao : strColuna + "_" + strOperacao;
 
-            if (umapGroupedData.find(chave) == umapGroupedData.end())
+            if (strOperacao == "count")
             {
-                umapGroupedData[chave] = {vector<vector<string>>(numAggregateColumns), valoresChave};
+                Column coluna(strNome, "int");
+                coluna.reserve(numGrupos);
+                for (size_t g = 0; g < numGrupos; ++g)
+                    coluna.appendInt(viContagem[g]);
+                dfAgrupado.vstrColumnsName.push_back(strNome);
+                dfAgrupado.columns.push_back(std::move(coluna));
+                continue;
             }
 
-            // Registro dos valores para cada coluna a agregar
-            for (size_t j = 0; j < viIndexColumnsToAggregate.size(); ++j)
+            auto it = find(vstrColumnsName.begin(), vstrColumnsName.end(), strColuna);
+            if (it == vstrColumnsName.end())
             {
-                int colIndex = viIndexColumnsToAggregate[j];
-                string valor = anyToString(columns[colIndex].getData()[i]);
-                umapGroupedData[chave].first[j].push_back(valor);
+                throw std::invalid_argument("Coluna de agregação '" + strColuna + "' não encontrada.");
             }
-        }
+            int idx = distance(vstrColumnsName.begin(), it);
+            const Column &origem = columns[idx];
 
-        // Montagem final das linhas agregadas
-        for (const auto &pair : umapGroupedData)
-        {
-            const auto &valoresChave = pair.second.second;
-            const auto &gruposDeValores = pair.second.first;
-            vector<any> linha;
+            Column coluna(strNome, "double");
+            coluna.reserve(numGrupos);
 
-            // Adiciona os valores das colunas de agrupamento
-            for (const auto &val : valoresChave)
+            if (origem.isInt() && (strOperacao == "sum" || strOperacao == "min" || strOperacao == "max"))
             {
-                linha.push_back(val);
-            }
+                // Colunas inteiras mantêm soma, mínimo e máximo exatos em int64
+                const auto &viDados = origem.intData();
+                vector<int64_t> viAcc(numGrupos, strOperacao == "min" ? INT64_MAX : (strOperacao == "max" ? INT64_MIN : 0));
+                if (strOperacao == "sum")
+                    for (size_t i = 0; i < numRows; ++i)
+                        viAcc[viGrupoDaLinha[i]] += viDados[i];
+                else if (strOperacao == "min")
+                    for (size_t i = 0; i < numRows; ++i)
+                        viAcc[viGrupoDaLinha[i]] = min(viAcc[viGrupoDaLinha[i]], viDados[i]);
+                else
+                    for (size_t i = 0; i < numRows; ++i)
+                        viAcc[viGrupoDaLinha[i]] = max(viAcc[viGrupoDaLinha[i]], viDados[i]);
 
-            // Para cada coluna agregada, calcular soma e/ou média
-            for (size_t j = 0; j < gruposDeValores.size(); ++j)
+                coluna = Column(strNome, "int");
+                coluna.reserve(numGrupos);
+                for (int64_t v : viAcc)
+                    coluna.appendInt(v);
+            }
+            else
             {
-                double soma_val = 0.0;
-                for (const auto &val : gruposDeValores[j])
+                auto itValores = umapValores.find(idx);
+                if (itValores == umapValores.end())
                 {
-                    try
+                    itValores = umapValores.emplace(idx, origem.toDoubleVector()).first;
+                }
+                const vector<double> &vdDados = itValores->second;
+
+                vector<double> vdAcc(numGrupos, 0.0);
+                if (strOperacao == "sum" || strOperacao == "mean" || strOperacao == "var")
+                {
+                    for (size_t i = 0; i < numRows; ++i)
+                        vdAcc[viGrupoDaLinha[i]] += vdDados[i];
+                    if (strOperacao != "sum")
                     {
-                        if (aggTypes[j] == "int")
-                            soma_val += stoi(val);
-                        else
-                            soma_val += stod(val);
+                        for (size_t g = 0; g < numGrupos; ++g)
+                            vdAcc[g] /= viContagem[g];
                     }
-                    catch (...)
+                    if (strOperacao == "var")
                     {
-                        soma_val += 0.0;
+                        // Segunda passada: soma dos quadrados dos desvios (variância amostral)
+                        vector<double> vdDesvios(numGrupos, 0.0);
+                        for (size_t i = 0; i < numRows; ++i)
+                        {
+                            double d = vdDados[i] - vdAcc[viGrupoDaLinha[i]];
+                            vdDesvios[viGrupoDaLinha[i]] += d * d;
+                        }
+                        for (size_t g = 0; g < numGrupos; ++g)
+                            vdAcc[g] = viContagem[g] > 1 ? vdDesvios[g] / (viContagem[g] - 1) : 0.0;
                     }
                 }
-                if (soma)
-                    linha.push_back((aggTypes[j] == "int") ? static_cast<int>(soma_val) : soma_val);
-                if (media)
+                else if (strOperacao == "min" || strOperacao == "max")
                 {
-                    double mean_val = gruposDeValores[j].empty() ? 0 : soma_val / gruposDeValores[j].size();
-                    linha.push_back(mean_val);
+                    bool bMin = strOperacao == "min";
+                    vdAcc.assign(numGrupos, bMin ? numeric_limits<double>::infinity() : -numeric_limits<double>::infinity());
+                    for (size_t i = 0; i < numRows; ++i)
+                    {
+                        double &acc = vdAcc[viGrupoDaLinha[i]];
+                        acc = bMin ? min(acc, vdDados[i]) : max(acc, vdDados[i]);
+                    }
                 }
+                else
+                {
+                    throw std::invalid_argument("Operação de agregação '" + strOperacao + "' não suportada.");
+                }
+
+                for (double v : vdAcc)
+                    coluna.appendDouble(v);
             }
-            if (contagem)
+
+            dfAgrupado.vstrColumnsName.push_back(strNome);
+            dfAgrupado.columns.push_back(std::move(coluna));
+        }
+
+        return dfAgrupado;
+    }
+
+    /**
+     * @brief Agrupa o DataFrame por uma coluna específica e aplica uma função de agregação.
+     * @param groupCols Colunas a serem usadas para agrupamento.
+     * @param vstrColumnsToAggregate Colunas a serem agregadas (se vazio, todas as colunas serão agregadas).
+     * @param soma Se true, realiza a soma das colunas agregadas.
+     * @param media Se true, realiza a média das colunas agregadas.
+     * @param contagem Se true, adiciona uma coluna de contagem.
+     * @return Um novo DataFrame com os dados agrupados e agregados.
+     */
+    Dataframe dfGroupby(const vector<string> &groupCols, vector<string> vstrColumnsToAggregate = {}, bool soma = true, bool media = true, bool contagem = true) const
+    {
+        // Define as colunas a serem agregadas (se não especificadas)
+        if (vstrColumnsToAggregate.empty())
+        {
+            vstrColumnsToAggregate = vstrColumnsName;
+            for (const auto &nomeCol : groupCols)
             {
-                int count_val = gruposDeValores.empty() ? 0 : gruposDeValores[0].size();
-                linha.push_back(count_val);
+                vstrColumnsToAggregate.erase(remove(vstrColumnsToAggregate.begin(), vstrColumnsToAggregate.end(), nomeCol), vstrColumnsToAggregate.end());
             }
+        }
 
-            dfAgrupado.adicionaLinha(linha);
+        vector<pair<string, string>> vAgregacoes;
+        for (const auto &col : vstrColumnsToAggregate)
+        {
+            if (soma)
+                vAgregacoes.emplace_back(col, "sum");
+            if (media)
+                vAgregacoes.emplace_back(col, "mean");
+        }
+        if (contagem)
+        {
+            vAgregacoes.emplace_back("", "count");
         }
 
-        return dfAgrupado;
+        return dfAgrega(groupCols, vAgregacoes);
     }
 
     /**
@@ -648,7 +842,7 @@ public:
     bool bColumnOperation(const string &strColumnName1, const string &strColumnName2, function<string(string, string)> funOperation, const string &strNewColumnName)
     {
         // Passo 1: criar a nova série
-        Series<any> newColumn(strNewColumnName, "string");
+        Column newColumn(strNewColumnName, "string");
 
         // Passo 2: verificar se as colunas existem
         auto it1 = find(vstrColumnsName.begin(), vstrColumnsName.end(), strColumnName1);
@@ -665,19 +859,45 @@ public:
 
         // Passo 3: operar elemento a elemento
         int iNumLinhas = columns[iIndex1].iGetSize();
+        newColumn.reserve(iNumLinhas);
         for (int i = 0; i < iNumLinhas; ++i)
         {
-            string strValue1 = anyToString(columns[iIndex1].retornaElemento(i));
-            string strValue2 = anyToString(columns[iIndex2].retornaElemento(i));
-            newColumn.bAdicionaElemento(funOperation(strValue1, strValue2));
+            string strValue1 = columns[iIndex1].getAsString(i);
+            string strValue2 = columns[iIndex2].getAsString(i);
+            newColumn.appendString(funOperation(strValue1, strValue2));
         }
 
         // Passo 4: adicionar a nova coluna
-        adicionaColuna(newColumn);
+        adicionaColuna(std::move(newColumn));
 
         return true;
     }
 
+    /**
+     * @brief Avalia uma expressão numérica e a grava como coluna double (substituindo uma coluna de mesmo nome).
+     *
+     * Exemplo: df.withColumn("preco_medio", col("preco_sum") / col("count_reservas")).
+     * @param strNomeColuna Nome da coluna resultante.
+     * @param expressao Expressão sobre as colunas do DataFrame.
+     * @return Referência para este DataFrame, permitindo encadear chamadas.
+     * @throw invalid_argument Se alguma coluna referenciada não existir.
+     */
+    Dataframe &withColumn(const string &strNomeColuna, const Expr &expressao)
+    {
+        Column coluna = expressao.avaliar(strNomeColuna, vstrColumnsName, columns);
+
+        auto it = find(vstrColumnsName.begin(), vstrColumnsName.end(), strNomeColuna);
+        if (it != vstrColumnsName.end())
+        {
+            columns[distance(vstrColumnsName.begin(), it)] = std::move(coluna);
+        }
+        else
+        {
+            adicionaColuna(std::move(coluna));
+        }
+        return *this;
+    }
+
     /**
      * @brief Realiza merge (inner join) entre este DataFrame e outro,
      *        usando uma ou mais colunas como chave.
@@ -700,82 +920,87 @@ public:
             idxB.push_back(distance(other.vstrColumnsName.begin(), itB));
         }
 
-        // 2. Criar DataFrame resultante
-        Dataframe result;
-
-        // Adicionar todas as colunas de df1
-        result.vstrColumnsName = vstrColumnsName;
-        for (const auto &col : columns)
-        {
-            result.columns.emplace_back(col.strGetName(), col.strGetType());
-        }
-
-        // Adicionar colunas de df2 que não estão em 'on'
+        // 2. Definir as colunas de df2 que não estão em 'on'
         vector<size_t> other_cols_idx; // Índices das colunas de df2 a incluir
         for (size_t j = 0; j < other.vstrColumnsName.size(); ++j)
         {
             if (find(on.begin(), on.end(), other.vstrColumnsName[j]) == on.end())
             {
-                result.vstrColumnsName.push_back(other.vstrColumnsName[j]);
-                result.columns.emplace_back(other.vstrColumnsName[j], other.columns[j].strGetType());
                 other_cols_idx.push_back(j);
             }
         }
 
-        // 3. Criar lookup para linhas de df2
-        unordered_map<string, vector<int>> lookup;
-        auto make_key = [&](const Dataframe &df, int row, const vector<int> &idx)
+        // 3. Criar lookup para linhas de df2, indexado pelo hash da chave composta
+        //    (colunas codificadas por dicionário são hasheadas e comparadas pelo código)
+        size_t rowsA = getShape().first;
+        size_t rowsB = other.getShape().first;
+        vector<uint64_t> hashesA(rowsA, 0), hashesB(rowsB, 0);
+        vector<const Column *> chavesA, chavesB;
+        vector<Column> convertidas;
+        convertidas.reserve(2 * on.size());
+        for (size_t k = 0; k < on.size(); ++k)
         {
-            string k;
-            for (int i : idx)
+            chavesA.push_back(&columns[idxA[k]]);
+            chavesB.push_back(&other.columns[idxB[k]]);
+            // Chaves de tipos diferentes são comparadas como texto
+            if (chavesA[k]->strGetType() != chavesB[k]->strGetType())
             {
-                k += anyToString(df.columns[i].retornaElemento(row)) + "\u0001";
+                convertidas.push_back(chavesA[k]->convertTo("string"));
+                chavesA[k] = &convertidas.back();
+                convertidas.push_back(chavesB[k]->convertTo("string"));
+                chavesB[k] = &convertidas.back();
             }
-            return k;
-        };
+            chavesA[k]->combinaHash(hashesA);
+            chavesB[k]->combinaHash(hashesB);
+        }
 
-        int rowsB = other.getShape().first;
-        for (int i = 0; i < rowsB; ++i)
+        unordered_map<uint64_t, vector<size_t>> lookup;
+        for (size_t i = 0; i < rowsB; ++i)
         {
-            lookup[make_key(other, i, idxB)].push_back(i);
+            lookup[hashesB[i]].push_back(i);
         }
 
-        // 4. Percorrer linhas de df1 e juntar com correspondentes em df2
-        int rowsA = getShape().first;
-        vector<any> newRow;
-        newRow.reserve(result.vstrColumnsName.size());
+        auto mesmaChave = [&](size_t iA, size_t jB)
+        {
+            for (size_t k = 0; k < on.size(); ++k)
+            {
+                if (!chavesA[k]->bValorIgual(iA, *chavesB[k], jB))
+                    return false;
+            }
+            return true;
+        };
 
-        for (int i = 0; i < rowsA; ++i)
+        // 4. Percorrer linhas de df1 e registrar os pares de linhas correspondentes
+        vector<size_t> linhasA, linhasB;
+
+        for (size_t i = 0; i < rowsA; ++i)
         {
-            string k = make_key(*this, i, idxA);
-            auto it = lookup.find(k);
+            auto it = lookup.find(hashesA[i]);
             if (it == lookup.end())
                 continue;
 
-            for (int jB : it->second)
+            for (size_t jB : it->second)
             {
-                newRow.clear();
-
-                // Adicionar todas as colunas de df1
-                for (const auto &col : columns)
-                {
-                    newRow.push_back(col.retornaElemento(i));
-                }
-
-                // Adicionar colunas de df2 que não estão em 'on'
-                for (size_t j : other_cols_idx)
-                {
-                    newRow.push_back(other.columns[j].retornaElemento(jB));
-                }
-
-                // Adicionar a linha ao resultado
-                if (!result.adicionaLinha(newRow))
-                {
-                    cerr << "Erro ao adicionar linha no merge." << endl;
-                }
+                if (!mesmaChave(i, jB))
+                    continue;
+                linhasA.push_back(i);
+                linhasB.push_back(jB);
             }
         }
 
+        // 5. Montar o resultado copiando as colunas de uma vez
+        Dataframe result;
+        result.vstrColumnsName = vstrColumnsName;
+        for (const auto &col : columns)
+        {
+            result.columns.push_back(col.gather(linhasA));
+        }
+        for (size_t j : other_cols_idx)
+        {
+            result.vstrColumnsName.push_back(other.vstrColumnsName[j]);
+            result.columns.push_back(other.columns[j].gather(linhasB));
+        }
+
         return result;
     }
 
@@ -816,7 +1041,8 @@ public:
      */
     friend ostream &operator<<(ostream &os, const Dataframe &dfInput)
     {
-        Dataframe df = dfInput;
+        // Só lê o DataFrame; não há motivo para copiá-lo
+        const Dataframe &df = dfInput;
         if (df.columns.empty())
         {
             os << "[Empty DataFrame]\n";
@@ -859,7 +1085,7 @@ public:
                 os << left << setw(index_width) << i << "  ";
                 for (size_t j = 0; j < num_cols; ++j)
                 {
-                    string val_str = anyToString(df.columns[j].retornaElemento(i));
+                    string val_str = df.columns[j].getAsString(i);
                     if (val_str.length() > size_t(col_width))
                         val_str = val_str.substr(0, col_width - 3) + "...";
                     os << left << setw(col_width) << val_str << "  ";
@@ -875,7 +1101,7 @@ public:
                 os << left << setw(index_width) << i << "  ";
                 for (size_t j = 0; j < num_cols; ++j)
                 {
-                    string val_str = anyToString(df.columns[j].retornaElemento(i));
+                    string val_str = df.columns[j].getAsString(i);
                     if (val_str.length() > size_t(col_width))
                         val_str = val_str.substr(0, col_width - 3) + "...";
                     os << left << setw(col_width) << val_str << "  ";
@@ -894,7 +1120,7 @@ public:
             os << left << setw(index_width) << last_index << "  ";
             for (size_t j = 0; j < num_cols; ++j)
             {
-                string val_str = anyToString(df.columns[j].retornaElemento(last_index));
+                string val_str = df.columns[j].getAsString(last_index);
                 if (val_str.length() > size_t(col_width))
                     val_str = val_str.substr(0, col_width - 3) + "...";
                 os << left << setw(col_width) << val_str << "  ";
@@ -905,6 +1131,25 @@ public:
         return os;
     }
 
+    /**
+     * @brief Renomeia uma coluna do DataFrame, sem copiar os valores.
+     * @param strNomeColuna Nome atual da coluna.
+     * @param strNovoNome Novo nome da coluna.
+     */
+    void renameCol(const string &strNomeColuna, const string &strNovoNome)
+    {
+        auto it = find(vstrColumnsName.begin(), vstrColumnsName.end(), strNomeColuna);
+        if (it != vstrColumnsName.end())
+        {
+            *it = strNovoNome;
+            columns[distance(vstrColumnsName.begin(), it)].setName(strNovoNome);
+        }
+        else
+        {
+            cout << "Coluna não encontrada: " << strNomeColuna << endl;
+        }
+    }
+
     /**
      * @brief Remove uma coluna do DataFrame pelo nome.
      * @param strNomeColuna Nome da coluna a ser removida.
@@ -980,90 +1225,15 @@ public:
         }
 
         int index = distance(vstrColumnsName.begin(), it);
-        const auto &data = columns[index].getData();
-        Series<any> newSeries(strNomeColuna, strTipo);
 
-        auto convert = [&](const any &value) -> any
+        try
         {
-            try
-            {
-                if (strTipo == "int")
-                {
-                    if (value.type() == typeid(int))
-                        return value;
-                    else if (value.type() == typeid(double))
-                        return static_cast<int>(any_cast<double>(value));
-                    else if (value.type() == typeid(string))
-                        return stoi(any_cast<string>(value));
-                    else
-                        throw invalid_argument("Cannot convert to int");
-                }
-                else if (strTipo == "double")
-                {
-                    if (value.type() == typeid(double))
-                        return value;
-                    else if (value.type() == typeid(int))
-                        return static_cast<double>(any_cast<int>(value));
-                    else if (value.type() == typeid(string))
-                        return stod(any_cast<string>(value));
-                    else
-                        throw invalid_argument("Cannot convert to double");
-                }
-                else if (strTipo == "string")
-                {
-                    if (value.type() == typeid(string))
-                        return value;
-                    else if (value.type() == typeid(int) || value.type() == typeid(double) || value.type() == typeid(bool))
-                        return anyToString(value);
-                    else
-                        throw invalid_argument("Cannot convert to string");
-                }
-                else if (strTipo == "bool")
-                {
-                    if (value.type() == typeid(bool))
-                        return value;
-                    else if (value.type() == typeid(int))
-                        return any_cast<int>(value) != 0;
-                    else if (value.type() == typeid(string))
-                    {
-                        string s = any_cast<string>(value);
-                        transform(s.begin(), s.end(), s.begin(), ::tolower);
-                        if (s == "true")
-                            return true;
-                        else if (s == "false")
-                            return false;
-                        else
-                            throw invalid_argument("Cannot convert to bool");
-                    }
-                    else
-                        throw invalid_argument("Cannot convert to bool");
-                }
-                else
-                {
-                    throw invalid_argument("Tipo inválido: " + strTipo);
-                }
-            }
-            catch (const exception &e)
-            {
-                throw invalid_argument("Erro ao converter valor '" + anyToString(value) + "' para " + strTipo + ": " + e.what());
-            }
-        };
-
-        for (const auto &value : data)
+            columns[index] = columns[index].convertTo(strTipo);
+        }
+        catch (const exception &e)
         {
-            try
-            {
-                any convertedValue = convert(value);
-                newSeries.bAdicionaElemento(convertedValue);
-            }
-            catch (const exception &e)
-            {
-                cerr << e.what() << endl;
-                return;
-            }
+            cerr << e.what() << endl;
         }
-
-        columns[index] = std::move(newSeries);
     }
 
     /**
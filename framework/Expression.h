@@ -0,0 +1,247 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include "Column.h"
+
+using namespace std;
+
+/**
+ * @class Expr
+ * @brief Expressão numérica sobre colunas de um DataFrame (ex.: col("preco_sum") / col("count_reservas")).
+ *
+ * A expressão é uma árvore imutável montada com col(), lit(), os operadores + - * / e as
+ * funções minimo()/maximo(). Na avaliação, cada coluna referenciada é lida uma única vez
+ * como vetor contíguo de double e a árvore inteira é avaliada em blocos de linhas: os
+ * resultados intermediários de cada bloco ficam em buffers pequenos (em cache), sem criar
+ * colunas temporárias nem passar por strings.
+ */
+class Expr
+{
+public:
+    enum class Tipo
+    {
+        Coluna,
+        Literal,
+        Soma,
+        Subtracao,
+        Multiplicacao,
+        Divisao,
+        Minimo,
+        Maximo
+    };
+
+private:
+    struct No
+    {
+        Tipo tipo;
+        string strColuna;
+        double dValor = 0.0;
+        shared_ptr<const No> esq, dir;
+    };
+
+    shared_ptr<const No> raiz;
+
+    // Número de linhas avaliadas por bloco
+    static constexpr size_t kTamanhoBloco = 1024;
+
+    // Colunas referenciadas já convertidas para double
+    struct Contexto
+    {
+        unordered_map<string, const double *> umapDados;
+        vector<vector<double>> vvdConvertidas;
+    };
+
+    explicit Expr(shared_ptr<const No> no) : raiz(std::move(no)) {}
+
+    static Expr binaria(Tipo tipo, const Expr &a, const Expr &b)
+    {
+        auto no = make_shared<No>();
+        no->tipo = tipo;
+        no->esq = a.raiz;
+        no->dir = b.raiz;
+        return Expr(no);
+    }
+
+    // Coleta os nomes das colunas usadas pela expressão
+    static void coletaColunas(const No *no, vector<string> &vstrColunas)
+    {
+        if (no->tipo == Tipo::Coluna)
+        {
+            if (find(vstrColunas.begin(), vstrColunas.end(), no->strColuna) == vstrColunas.end())
+                vstrColunas.push_back(no->strColuna);
+            return;
+        }
+        if (no->esq)
+            coletaColunas(no->esq.get(), vstrColunas);
+        if (no->dir)
+            coletaColunas(no->dir.get(), vstrColunas);
+    }
+
+    // Retorna um ponteiro para os valores do nó no bloco (direto da coluna, quando possível)
+    static const double *operando(const No *no, const Contexto &ctx, size_t inicio, size_t n, double *tmp)
+    {
+        if (no->tipo == Tipo::Coluna)
+            return ctx.umapDados.at(no->strColuna) + inicio;
+        avaliaBloco(no, ctx, inicio, n, tmp);
+        return tmp;
+    }
+
+    // Avalia o nó para as linhas [inicio, inicio + n), escrevendo em saida
+    static void avaliaBloco(const No *no, const Contexto &ctx, size_t inicio, size_t n, double *saida)
+    {
+        if (no->tipo == Tipo::Literal)
+        {
+            fill(saida, saida + n, no->dValor);
+            return;
+        }
+        if (no->tipo == Tipo::Coluna)
+        {
+            const double *dados = ctx.umapDados.at(no->strColuna) + inicio;
+            copy(dados, dados + n, saida);
+            return;
+        }
+
+        double tmpA[kTamanhoBloco];
+        double tmpB[kTamanhoBloco];
+        const double *a = operando(no->esq.get(), ctx, inicio, n, tmpA);
+        const double *b = operando(no->dir.get(), ctx, inicio, n, tmpB);
+
+        switch (no->tipo)
+        {
+        case Tipo::Soma:
+            for (size_t i = 0; i < n; i++)
+                saida[i] = a[i] + b[i];
+            break;
+        case Tipo::Subtracao:
+            for (size_t i = 0; i < n; i++)
+                saida[i] = a[i] - b[i];
+            break;
+        case Tipo::Multiplicacao:
+            for (size_t i = 0; i < n; i++)
+                saida[i] = a[i] * b[i];
+            break;
+        case Tipo::Divisao:
+            for (size_t i = 0; i < n; i++)
+                saida[i] = a[i] / b[i];
+            break;
+        case Tipo::Minimo:
+            for (size_t i = 0; i < n; i++)
+                saida[i] = a[i] < b[i] ? a[i] : b[i];
+            break;
+        case Tipo::Maximo:
+            for (size_t i = 0; i < n; i++)
+                saida[i] = a[i] > b[i] ? a[i] : b[i];
+            break;
+        default:
+            break;
+        }
+    }
+
+public:
+    /**
+     * @brief Cria uma expressão que referencia uma coluna.
+     * @param strColuna Nome da coluna.
+     */
+    static Expr coluna(const string &strColuna)
+    {
+        auto no = make_shared<No>();
+        no->tipo = Tipo::Coluna;
+        no->strColuna = strColuna;
+        return Expr(no);
+    }
+
+    /**
+     * @brief Cria uma expressão constante.
+     * @param dValor Valor da constante.
+     */
+    static Expr literal(double dValor)
+    {
+        auto no = make_shared<No>();
+        no->tipo = Tipo::Literal;
+        no->dValor = dValor;
+        return Expr(no);
+    }
+
+    Expr(double dValor) : Expr(literal(dValor)) {}
+
+    friend Expr operator+(const Expr &a, const Expr &b) { return binaria(Tipo::Soma, a, b); }
+    friend Expr operator-(const Expr &a, const Expr &b) { return binaria(Tipo::Subtracao, a, b); }
+    friend Expr operator*(const Expr &a, const Expr &b) { return binaria(Tipo::Multiplicacao, a, b); }
+    friend Expr operator/(const Expr &a, const Expr &b) { return binaria(Tipo::Divisao, a, b); }
+    friend Expr minimo(const Expr &a, const Expr &b) { return binaria(Tipo::Minimo, a, b); }
+    friend Expr maximo(const Expr &a, const Expr &b) { return binaria(Tipo::Maximo, a, b); }
+
+    /**
+     * @brief Avalia a expressão para todas as linhas.
+     *
+     * Colunas double são lidas diretamente; colunas int, bool ou string são convertidas
+     * uma vez (strings não numéricas viram 0.0). Divisões por zero seguem o IEEE 754 (inf/nan).
+     *
+     * @param strNome Nome da coluna resultante.
+     * @param vstrNomes Nomes das colunas do DataFrame.
+     * @param colunas Colunas do DataFrame.
+     * @return Coluna double com o resultado.
+     * @throw invalid_argument Se alguma coluna referenciada não existir.
+     */
+    Column avaliar(const string &strNome, const vector<string> &vstrNomes, const vector<Column> &colunas) const
+    {
+        vector<string> vstrUsadas;
+        coletaColunas(raiz.get(), vstrUsadas);
+
+        Contexto ctx;
+        ctx.vvdConvertidas.reserve(vstrUsadas.size());
+        size_t numLinhas = 0;
+        bool bTemColuna = false;
+        for (const auto &strColuna : vstrUsadas)
+        {
+            auto it = find(vstrNomes.begin(), vstrNomes.end(), strColuna);
+            if (it == vstrNomes.end())
+            {
+                throw invalid_argument("Coluna '" + strColuna + "' não encontrada.");
+            }
+            const Column &coluna = colunas[distance(vstrNomes.begin(), it)];
+            if (coluna.isDouble())
+            {
+                ctx.umapDados[strColuna] = coluna.doubleData().data();
+            }
+            else
+            {
+                ctx.vvdConvertidas.push_back(coluna.toDoubleVector());
+                ctx.umapDados[strColuna] = ctx.vvdConvertidas.back().data();
+            }
+            numLinhas = bTemColuna ? min(numLinhas, coluna.iGetSize()) : coluna.iGetSize();
+            bTemColuna = true;
+        }
+        if (!bTemColuna && !colunas.empty())
+        {
+            numLinhas = colunas[0].iGetSize();
+        }
+
+        vector<double> vdResultado(numLinhas);
+        for (size_t inicio = 0; inicio < numLinhas; inicio += kTamanhoBloco)
+        {
+            size_t n = min(kTamanhoBloco, numLinhas - inicio);
+            avaliaBloco(raiz.get(), ctx, inicio, n, vdResultado.data() + inicio);
+        }
+
+        return Column::fromDoubleVector(strNome, vdResultado);
+    }
+};
+
+/**
+ * @brief Atalho para Expr::coluna.
+ */
+inline Expr col(const string &strColuna) { return Expr::coluna(strColuna); }
+
+/**
+ * @brief Atalho para Expr::literal.
+ */
+inline Expr lit(double dValor) { return Expr::literal(dValor); }
+
+#endif // EXPRESSION_H
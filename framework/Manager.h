@@ -9,8 +9,13 @@
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <map>
+#include <set>
+#include <optional>
+#include <string>
 #include "BaseClasses.h"
 #include "TaskQueue.h"
+#include "Scheduler.h"
 #include "Transformer.h"
 
 // Classe do gerenciador das threads
@@ -20,8 +25,12 @@ class Manager
     private:
         // Vetor das threads
         std::vector<std::thread> threads;
+        // Níveis de prioridade da fila de tarefas (ver setSchedulingPolicy)
+        static constexpr int kPriorityLevels = 4;
         // Fila de tarefas
         TaskQueue task_queue;
+        // Escalonador das etapas, que despacha o trabalho delas como tarefas da fila
+        Scheduler scheduler{&task_queue};
         std::mutex mtx;
         std::condition_variable cond;
         // Indicador se o trabalho foi interrompido
@@ -32,17 +41,160 @@ class Manager
         std::vector<Extrator<T>*> extractors;
         std::vector<Transformer<T>*> transformers;
         std::vector<Loader<T>*> loaders;
+        // Arenas reaproveitadas pelos batches dos extratores (ver ArenaPool)
+        std::shared_ptr<ArenaPool> arenaPool = std::make_shared<ArenaPool>();
+
+        // Conjunto de colunas exigido de um buffer; nullopt significa "todas as colunas"
+        using ColumnSet = std::optional<std::set<std::string>>;
+        std::map<Buffer<T>*, ColumnSet> requiredColumns;
+
+        // Calcula as colunas que um buffer precisa carregar, a partir das etapas que o consomem
+        ColumnSet computeRequiredColumns(Buffer<T>* buffer)
+        {
+            auto it = requiredColumns.find(buffer);
+            if (it != requiredColumns.end())
+            {
+                return it->second;
+            }
+
+            std::set<std::string> columns;
+            bool hasConsumer = false;
+            bool needsAll = false;
+
+            for (auto* loader : loaders)
+            {
+                if (&loader->get_input_buffer() != buffer)
+                {
+                    continue;
+                }
+                hasConsumer = true;
+                if (!loader->hasDeclaredColumns())
+                {
+                    needsAll = true;
+                    break;
+                }
+                columns.insert(loader->getReadColumns().begin(), loader->getReadColumns().end());
+            }
+
+            for (size_t t = 0; t < transformers.size() && !needsAll; t++)
+            {
+                Transformer<T>* transformer = transformers[t];
+                std::vector<Buffer<T>*> inputs = transformer->get_input_buffers();
+                if (std::find(inputs.begin(), inputs.end(), buffer) == inputs.end())
+                {
+                    continue;
+                }
+                hasConsumer = true;
+                if (!transformer->hasDeclaredColumns())
+                {
+                    needsAll = true;
+                    break;
+                }
+                columns.insert(transformer->getReadColumns().begin(), transformer->getReadColumns().end());
+
+                // Colunas repassadas também precisam atender às etapas seguintes
+                if (transformer->getPassesColumnsThrough())
+                {
+                    for (int i = 0; i < transformer->get_num_output_buffers() && !needsAll; i++)
+                    {
+                        ColumnSet downstream = computeRequiredColumns(&transformer->get_output_buffer_by_index(i));
+                        if (!downstream)
+                        {
+                            needsAll = true;
+                        }
+                        else
+                        {
+                            columns.insert(downstream->begin(), downstream->end());
+                        }
+                    }
+                }
+            }
+
+            // Um buffer sem consumidores conhecidos mantém todas as colunas
+            ColumnSet result;
+            if (hasConsumer && !needsAll)
+            {
+                result = columns;
+            }
+            requiredColumns[buffer] = result;
+            return result;
+        }
+
+        // Poda de colunas: cada extrator sem projeção explícita passa a ler só as colunas exigidas
+        void pruneColumns()
+        {
+            requiredColumns.clear();
+            for (auto* extractor : extractors)
+            {
+                ColumnSet needed = computeRequiredColumns(&extractor->get_output_buffer());
+                if (!needed || extractor->hasProjection())
+                {
+                    continue;
+                }
+
+                // Mantém a ordem do cabeçalho; colunas criadas por etapas seguintes não existem aqui
+                std::vector<std::string> projection;
+                for (const auto& column : extractor->getColumnsName())
+                {
+                    if (needed->count(column))
+                    {
+                        projection.push_back(column);
+                    }
+                }
+                if (!projection.empty())
+                {
+                    extractor->setProjection(projection);
+                }
+            }
+        }
+
+        // Marca os transformadores cujas saídas só vão para etapas que aceitam seleção,
+        // para que os batches filtrados sigam sem ser compactados
+        void markSelectionConsumers()
+        {
+            for (auto* producer : transformers)
+            {
+                bool accepts = true;
+                bool hasConsumer = false;
+                for (int i = 0; i < producer->get_num_output_buffers() && accepts; i++)
+                {
+                    Buffer<T>* buffer = &producer->get_output_buffer_by_index(i);
+                    for (auto* loader : loaders)
+                    {
+                        if (&loader->get_input_buffer() == buffer)
+                        {
+                            accepts = false;
+                        }
+                    }
+                    for (auto* consumer : transformers)
+                    {
+                        std::vector<Buffer<T>*> inputs = consumer->get_input_buffers();
+                        if (std::find(inputs.begin(), inputs.end(), buffer) != inputs.end())
+                        {
+                            hasConsumer = true;
+                            accepts = accepts && consumer->acceptsSelection();
+                        }
+                    }
+                }
+                producer->setOutputAcceptsSelection(accepts && hasConsumer);
+            }
+        }
 
     public:
         // Método construtor
-        Manager(int num_threads)
+        Manager(int num_threads) : task_queue(num_threads, kPriorityLevels)
         {
+            scheduler.setPolicy(std::make_shared<SinkFirstPolicy>());
+
             // Para cada thread...
             for (int i = 0; i < num_threads; i++)
             {
                 // Cria ela
-                threads.emplace_back([this]
+                threads.emplace_back([this, i]
                 {
+                    // Associa a thread ao seu deque de tarefas na fila
+                    task_queue.registerWorker(i);
+
                     // Espera até o processo ser iniciado ou finalizado
                     std::unique_lock<std::mutex> lock(mtx);
 
@@ -74,6 +226,7 @@ class Manager
         void addExtractor(Extrator<T>* extractor)
         {
             extractor -> set_taskqueue(&task_queue);
+            extractor -> setArenaPool(arenaPool);
             extractors.push_back(extractor);
         }
         void addTransformer(Transformer<T>* transformer)
@@ -85,72 +238,124 @@ class Manager
         {
             loader -> set_taskqueue(&task_queue);
             loaders.push_back(loader);
-            // Aumenta em 1 a contagem de loaders da taskqueue
-            task_queue.getNumberOfLoaders().notify();
         }
 
-        // Método para começar a executar o processo
-        void run()
+        // Registra as etapas no escalonador e liga cada buffer às etapas que ele acorda:
+        // o consumidor quando chegam dados, o produtor quando uma vaga é liberada
+        void connectStages()
         {
-            // Chama as threads para começarem a pegar coisas da fila de tarefas
+            // Etapa que produz cada buffer
+            std::map<Buffer<T>*, Stage*> producers;
+            for (auto* extractor : extractors)
             {
-                std::lock_guard<std::mutex> lock(mtx);
-                running = true;
+                scheduler.addStage(extractor);
+                producers[&extractor->get_output_buffer()] = extractor;
+                extractor->get_output_buffer().on_space([extractor] { extractor->wakeUp(); });
             }
-            cond.notify_all();
-
-            // Cria uma thread para cada bloco de processo e começa a mandar tarefas pra fila
-            for (int i = 0; i < extractors.size(); i++)
+            for (auto* transformer : transformers)
             {
-                threads.emplace_back([this, i]()
+                scheduler.addStage(transformer);
+                for (int i = 0; i < transformer->get_num_output_buffers(); i++)
                 {
-                    extractors[i] -> enqueue_tasks();
-                });
+                    producers[&transformer->get_output_buffer_by_index(i)] = transformer;
+                    transformer->get_output_buffer_by_index(i).on_space([transformer] { transformer->wakeUp(); });
+                }
             }
-            for (int i = 0; i < transformers.size(); i++)
+            for (auto* loader : loaders)
             {
-                threads.emplace_back([this,i]
-                {
-                    transformers[i] -> enqueue_tasks();
-                });
+                scheduler.addStage(loader);
             }
-            for (int i = 0; i < loaders.size(); i++)
+
+            // Liga os consumidores e registra as arestas do grafo (usadas pela política de escalonamento)
+            auto connect = [&](Buffer<T>* buffer, Stage* consumer)
             {
-                threads.emplace_back([this,i]
+                buffer->on_data([consumer] { consumer->wakeUp(); });
+                auto it = producers.find(buffer);
+                if (it != producers.end())
                 {
-                    loaders[i] -> enqueue_tasks();
-                });
+                    scheduler.addEdge(it->second, consumer, [buffer]
+                    {
+                        return static_cast<double>(buffer->size()) / buffer->get_max_size();
+                    });
+                }
+            };
+            for (auto* transformer : transformers)
+            {
+                for (Buffer<T>* buffer : transformer->get_input_buffers())
+                {
+                    connect(buffer, transformer);
+                }
             }
+            for (auto* loader : loaders)
+            {
+                connect(&loader->get_input_buffer(), loader);
+            }
+        }
 
-            // Começa a verificar quando o trabalho vai acabar
+        /**
+         * Define a política que dá prioridade às tarefas de cada etapa (ver SchedulingPolicy).
+         * Padrão: SinkFirstPolicy. Deve ser chamado antes de run().
+         */
+        void setSchedulingPolicy(std::shared_ptr<SchedulingPolicy> policy)
+        {
+            scheduler.setPolicy(std::move(policy));
+        }
+
+        // Método para começar a executar o processo
+        void run()
+        {
+            // Calcula as colunas exigidas por cada buffer e poda as colunas extraídas
+            pruneColumns();
+            markSelectionConsumers();
+            connectStages();
+
+            // Chama as threads para começarem a pegar coisas da fila de tarefas
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                running = true;
+            }
+            cond.notify_all();
+
+            // Despacha as etapas: elas rodam como tarefas da pool, sem threads próprias
+            scheduler.start();
+
+            // Espera o trabalho acabar
             stop();
         }
 
-        // Método para verificar quando o trabalho será encerrado e o encerrar
+        // Método para esperar o fim do trabalho e encerrar as threads
+        // A thread que chama dorme até todas as etapas terminarem
         void stop()
         {
-            // Espera até todos os loaders terminarem de colocar tarefa na fila
-            task_queue.waitLoadersFinish();
+            // Se o pipeline não foi iniciado ou já foi encerrado, não há o que esperar
+            bool waitWork;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                waitWork = running && !finishedWork;
+            }
+
+            if (waitWork)
+            {
+                // Espera até todas as etapas terminarem (entradas esgotadas e tarefas concluídas)
+                scheduler.wait();
+
+                // Depois disso, espera a fila esvaziar
+                task_queue.waitEmpty();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                finishedWork = true;
+            }
 
-            // Depois disso, fica checando quando a fila acabar
-            while (true)
+            // E encerra as threads (as tarefas em execução terminam antes do join)
+            cond.notify_all();
+            task_queue.shutdown();
+            for (auto& thread : threads)
             {
-                if (task_queue.is_empty())
+                if (thread.joinable())
                 {
-                    // E encerra as threads
-                    for (auto& thread : threads)
-                    {
-                        {
-                            std::lock_guard<std::mutex> lock(mtx);
-                            finishedWork = true;
-                        }
-                        task_queue.shutdown();
-                        if (thread.joinable())
-                        {
-                            thread.join();
-                        }
-                    }
-                    break;
+                    thread.join();
                 }
             }
         }
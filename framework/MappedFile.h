@@ -0,0 +1,217 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @class MappedFile
+ * @brief Mapeia um arquivo inteiro em memória (somente leitura) com mmap.
+ *
+ * O conteúdo é exposto como string_view, permitindo que as tarefas de extração
+ * leiam trechos do arquivo sem copiá-los. O mapeamento é desfeito no destrutor.
+ */
+class MappedFile
+{
+private:
+    const char *pDados = nullptr; // Início do mapeamento
+    size_t iTamanho = 0;          // Tamanho do arquivo em bytes
+
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Mapeia o arquivo indicado.
+     * @param strCaminho Caminho do arquivo.
+     * @throws std::runtime_error se o arquivo não puder ser aberto ou mapeado.
+     */
+    explicit MappedFile(const std::string &strCaminho)
+    {
+        int fd = ::open(strCaminho.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Falha ao abrir o arquivo.");
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Falha ao obter o tamanho do arquivo.");
+        }
+
+        iTamanho = static_cast<size_t>(info.st_size);
+        if (iTamanho > 0)
+        {
+            void *p = mmap(nullptr, iTamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Falha ao mapear o arquivo em memória.");
+            }
+            // O arquivo é lido sequencialmente pelas tarefas
+            madvise(p, iTamanho, MADV_SEQUENTIAL);
+            pDados = static_cast<const char *>(p);
+        }
+
+        // O mapeamento continua válido após fechar o descritor
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept : pDados(other.pDados), iTamanho(other.iTamanho)
+    {
+        other.pDados = nullptr;
+        other.iTamanho = 0;
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            pDados = other.pDados;
+            iTamanho = other.iTamanho;
+            other.pDados = nullptr;
+            other.iTamanho = 0;
+        }
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        unmap();
+    }
+
+    /**
+     * @brief Retorna o conteúdo completo do arquivo.
+     */
+    std::string_view view() const
+    {
+        return std::string_view(pDados, iTamanho);
+    }
+
+    /**
+     * @brief Indica se há um arquivo mapeado.
+     */
+    bool isOpen() const { return pDados != nullptr; }
+
+    /**
+     * @brief Calcula a fronteira de linha associada a um deslocamento do texto.
+     *
+     * A fronteira é a posição logo após o primeiro '\n' encontrado a partir de iAlvo
+     * (0 para iAlvo == 0 e o fim do texto se não houver mais quebras de linha).
+     * Como depende apenas de iAlvo, cada fronteira pode ser calculada de forma
+     * independente, inclusive pela própria tarefa que vai processar o bloco.
+     * Não considera aspas: só é válida para textos em que temQuebraEntreAspas é falso
+     * (nos demais, use fronteiraDeRegistro).
+     *
+     * @param strTexto Texto completo.
+     * @param iAlvo Deslocamento aproximado da fronteira.
+     * @return Deslocamento da fronteira alinhada.
+     */
+    static size_t fronteiraDeLinha(std::string_view strTexto, size_t iAlvo)
+    {
+        if (iAlvo == 0)
+            return 0;
+        if (iAlvo >= strTexto.size())
+            return strTexto.size();
+        const void *nl = memchr(strTexto.data() + iAlvo, '\n', strTexto.size() - iAlvo);
+        return nl ? static_cast<const char *>(nl) - strTexto.data() + 1 : strTexto.size();
+    }
+
+    /**
+     * @brief Retorna as linhas que começam no intervalo de bytes [iInicio, iFim) de um texto.
+     *
+     * As duas pontas são avançadas até o próximo '\n' (ver fronteiraDeLinha), de modo que
+     * intervalos consecutivos cobrem cada linha exatamente uma vez, mesmo com tamanhos diferentes.
+     * @return View do bloco (vazia se uma linha longa cobrir o intervalo inteiro).
+     */
+    static std::string_view blocoEntre(std::string_view strTexto, size_t iInicio, size_t iFim)
+    {
+        size_t inicio = fronteiraDeLinha(strTexto, iInicio);
+        size_t fim = fronteiraDeLinha(strTexto, iFim);
+        return strTexto.substr(inicio, fim > inicio ? fim - inicio : 0);
+    }
+
+    /**
+     * @brief Calcula a fronteira de registro CSV associada a um deslocamento, respeitando aspas.
+     *
+     * Como fronteiraDeLinha, mas ignora os '\n' dentro de campos entre aspas. Para saber se
+     * um '\n' está entre aspas é preciso percorrer as aspas desde um ponto fora delas, por
+     * isso iInicio deve ser o início de um registro (por exemplo, a fronteira anterior).
+     *
+     * @param strTexto Texto completo.
+     * @param iInicio Início de um registro, anterior ou igual a iAlvo.
+     * @param iAlvo Deslocamento aproximado da fronteira.
+     * @return Deslocamento da fronteira alinhada.
+     */
+    static size_t fronteiraDeRegistro(std::string_view strTexto, size_t iInicio, size_t iAlvo)
+    {
+        const char *pTexto = strTexto.data();
+        size_t pos = iInicio;
+        while (true)
+        {
+            size_t fim = fronteiraDeLinha(strTexto, std::max(iAlvo, pos));
+            const void *aspa = memchr(pTexto + pos, '"', fim - pos);
+            if (!aspa)
+                return fim;
+
+            // Pula o campo entre aspas ("" dentro dele fecha e reabre as aspas)
+            size_t abertura = static_cast<const char *>(aspa) - pTexto + 1;
+            const void *fechamento = memchr(pTexto + abertura, '"', strTexto.size() - abertura);
+            if (!fechamento)
+                return strTexto.size();
+            pos = static_cast<const char *>(fechamento) - pTexto + 1;
+        }
+    }
+
+    /**
+     * @brief Indica se algum campo entre aspas do texto contém uma quebra de linha.
+     *
+     * Nesse caso as fronteiras de fronteiraDeLinha e blocoEntre podem cortar um registro ao
+     * meio, e os blocos devem ser alinhados com fronteiraDeRegistro. Textos sem aspas são
+     * verificados com uma única busca por '"'.
+     */
+    static bool temQuebraEntreAspas(std::string_view strTexto)
+    {
+        const char *pTexto = strTexto.data();
+        size_t pos = 0;
+        while (pos < strTexto.size())
+        {
+            const void *aspa = memchr(pTexto + pos, '"', strTexto.size() - pos);
+            if (!aspa)
+                return false;
+            size_t abertura = static_cast<const char *>(aspa) - pTexto + 1;
+            const void *fechamento = memchr(pTexto + abertura, '"', strTexto.size() - abertura);
+            size_t fim = fechamento ? static_cast<const char *>(fechamento) - pTexto : strTexto.size();
+            if (memchr(pTexto + abertura, '\n', fim - abertura))
+                return true;
+            pos = fim + 1;
+        }
+        return false;
+    }
+
+private:
+    void unmap()
+    {
+        if (pDados)
+        {
+            munmap(const_cast<char *>(pDados), iTamanho);
+            pDados = nullptr;
+            iTamanho = 0;
+        }
+    }
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,269 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "TaskQueue.h"
+
+// Registro de métricas nomeadas e tipadas de uma etapa do pipeline
+//
+// Há três tipos de métrica: contadores (int64, exatos), somas (double) e histogramas
+// (contagem por faixa de valores). Cada thread da pool escreve em um shard próprio, com
+// as células de cada shard em linhas de cache separadas, então atualizar uma métrica não
+// toma lock nem disputa a linha de cache com as outras threads; a leitura soma os shards.
+// Threads de fora da pool compartilham um shard extra, atualizado com operações atômicas.
+//
+// As métricas devem ser registradas e o registro ligado à fila de tarefas (attach) antes
+// de o pipeline começar a rodar.
+class Metrics
+{
+public:
+    enum class Kind
+    {
+        Counter,
+        Sum,
+        Histogram
+    };
+
+private:
+    struct Definition
+    {
+        std::string name;
+        Kind kind;
+        std::vector<double> bounds; // Limites superiores das faixas do histograma
+        size_t firstCell;           // Primeira célula da métrica dentro do shard
+        size_t numCells;            // Células usadas (1, ou bounds.size() + 1 para histogramas)
+    };
+
+    // Uma linha de cache de células; cada shard começa em uma linha nova
+    struct alignas(64) CacheLine
+    {
+        std::atomic<uint64_t> cells[8];
+    };
+
+    std::vector<Definition> definitions;
+    size_t numCells = 0;
+    size_t linesPerShard = 0;
+    int numShards = 1;                 // Um shard por thread da pool, mais o compartilhado (índice 0)
+    std::vector<CacheLine> lines;
+    TaskQueue* taskqueue = nullptr;
+
+    // (Re)aloca os shards zerados para o layout atual
+    void allocate()
+    {
+        linesPerShard = (numCells + 7) / 8;
+        std::vector<CacheLine> fresh(linesPerShard * numShards);
+        for (auto& line : fresh)
+        {
+            for (auto& cell : line.cells)
+            {
+                cell.store(0, std::memory_order_relaxed);
+            }
+        }
+        lines.swap(fresh);
+    }
+
+    int declare(const std::string& name, Kind kind, std::vector<double> bounds = {})
+    {
+        if (find(name) >= 0)
+        {
+            throw std::invalid_argument("Métrica '" + name + "' já registrada.");
+        }
+        Definition definition{name, kind, std::move(bounds), numCells, 1};
+        if (kind == Kind::Histogram)
+        {
+            std::sort(definition.bounds.begin(), definition.bounds.end());
+            definition.numCells = definition.bounds.size() + 1;
+        }
+        numCells += definition.numCells;
+        definitions.push_back(std::move(definition));
+        allocate();
+        return static_cast<int>(definitions.size()) - 1;
+    }
+
+    std::atomic<uint64_t>& cell(int shard, size_t index)
+    {
+        return lines[shard * linesPerShard + index / 8].cells[index % 8];
+    }
+
+    // Shard da thread atual: o próprio, para threads da pool, ou o compartilhado
+    int currentShard() const
+    {
+        int worker = taskqueue ? taskqueue->currentWorkerIndex() : -1;
+        return worker >= 0 && worker + 1 < numShards ? worker + 1 : 0;
+    }
+
+    static uint64_t fromDouble(double value)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static double toDouble(uint64_t bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Incrementa uma célula inteira: escrita simples no shard próprio, atômica no compartilhado
+    void addInt(int shard, size_t index, int64_t delta)
+    {
+        std::atomic<uint64_t>& target = cell(shard, index);
+        if (shard > 0)
+        {
+            target.store(target.load(std::memory_order_relaxed) + static_cast<uint64_t>(delta), std::memory_order_relaxed);
+        }
+        else
+        {
+            target.fetch_add(static_cast<uint64_t>(delta), std::memory_order_relaxed);
+        }
+    }
+
+    void addDouble(int shard, size_t index, double delta)
+    {
+        std::atomic<uint64_t>& target = cell(shard, index);
+        uint64_t expected = target.load(std::memory_order_relaxed);
+        if (shard > 0)
+        {
+            target.store(fromDouble(toDouble(expected) + delta), std::memory_order_relaxed);
+            return;
+        }
+        while (!target.compare_exchange_weak(expected, fromDouble(toDouble(expected) + delta), std::memory_order_relaxed))
+        {
+        }
+    }
+
+    const Definition& definition(const std::string& name, Kind kind) const
+    {
+        int id = find(name);
+        if (id < 0 || definitions[id].kind != kind)
+        {
+            throw std::invalid_argument("Métrica '" + name + "' não registrada com esse tipo.");
+        }
+        return definitions[id];
+    }
+
+    uint64_t total(size_t index, bool isDouble) const
+    {
+        int64_t intTotal = 0;
+        double doubleTotal = 0.0;
+        for (int shard = 0; shard < numShards; shard++)
+        {
+            uint64_t bits = lines[shard * linesPerShard + index / 8].cells[index % 8].load(std::memory_order_relaxed);
+            if (isDouble)
+                doubleTotal += toDouble(bits);
+            else
+                intTotal += static_cast<int64_t>(bits);
+        }
+        return isDouble ? fromDouble(doubleTotal) : static_cast<uint64_t>(intTotal);
+    }
+
+public:
+    Metrics() { allocate(); }
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * Liga o registro à fila de tarefas, criando um shard por thread da pool.
+     * Zera os valores acumulados.
+     */
+    void attach(TaskQueue* tq)
+    {
+        taskqueue = tq;
+        numShards = 1 + (tq ? tq->numWorkers() : 0);
+        allocate();
+    }
+
+    // Registro das métricas; cada método retorna o identificador usado nas atualizações
+    int addCounter(const std::string& name) { return declare(name, Kind::Counter); }
+    int addSum(const std::string& name) { return declare(name, Kind::Sum); }
+    int addHistogram(const std::string& name, std::vector<double> bounds) { return declare(name, Kind::Histogram, std::move(bounds)); }
+
+    /**
+     * Retorna o identificador de uma métrica, ou -1 se ela não existir.
+     */
+    int find(const std::string& name) const
+    {
+        for (size_t i = 0; i < definitions.size(); i++)
+        {
+            if (definitions[i].name == name)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Getters das definições
+    size_t size() const { return definitions.size(); }
+    const std::string& name(int id) const { return definitions[id].name; }
+    Kind kind(int id) const { return definitions[id].kind; }
+
+    // Atualizações (sem lock): contadores e histogramas com inteiros, somas com doubles
+    void increment(int id, int64_t delta = 1) { addInt(currentShard(), definitions[id].firstCell, delta); }
+    void accumulate(int id, double delta) { addDouble(currentShard(), definitions[id].firstCell, delta); }
+
+    /**
+     * Conta `count` observações de `value` no histograma (faixa i: bounds[i-1] < value <= bounds[i]).
+     */
+    void observe(int id, double value, int64_t count = 1)
+    {
+        const Definition& definition = definitions[id];
+        size_t bucket = std::lower_bound(definition.bounds.begin(), definition.bounds.end(), value) - definition.bounds.begin();
+        addInt(currentShard(), definition.firstCell + bucket, count);
+    }
+
+    // Leituras: somam os shards de todas as threads
+    int64_t counter(const std::string& name) const
+    {
+        return static_cast<int64_t>(total(definition(name, Kind::Counter).firstCell, false));
+    }
+
+    double sum(const std::string& name) const
+    {
+        return toDouble(total(definition(name, Kind::Sum).firstCell, true));
+    }
+
+    std::vector<int64_t> histogram(const std::string& name) const
+    {
+        const Definition& definition = this->definition(name, Kind::Histogram);
+        std::vector<int64_t> buckets(definition.numCells);
+        for (size_t b = 0; b < definition.numCells; b++)
+        {
+            buckets[b] = static_cast<int64_t>(total(definition.firstCell + b, false));
+        }
+        return buckets;
+    }
+
+    /**
+     * Retorna o valor de um contador ou soma como double (histogramas: total de observações).
+     */
+    double value(int id) const
+    {
+        const Definition& definition = definitions[id];
+        switch (definition.kind)
+        {
+        case Kind::Counter:
+            return static_cast<double>(counter(definition.name));
+        case Kind::Sum:
+            return sum(definition.name);
+        default:
+        {
+            int64_t observations = 0;
+            for (int64_t bucket : histogram(definition.name))
+                observations += bucket;
+            return static_cast<double>(observations);
+        }
+        }
+    }
+};
+
+#endif // METRICS_H
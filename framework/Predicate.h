@@ -0,0 +1,459 @@
+#ifndef PREDICATE_H
+#define PREDICATE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include <unordered_map>
+#include <any>
+#include <cstdint>
+#include <cmath>
+#include <charconv>
+#include "Column.h"
+
+using namespace std;
+
+/**
+ * @class Selecao
+ * @brief Conjunto de linhas selecionadas de um batch, guardado como bitmap (1 bit por linha).
+ *
+ * É o resultado da avaliação de um Predicado: as linhas não são copiadas, e o operador
+ * seguinte percorre apenas as linhas marcadas (paraCada) ou compacta o batch quando precisar.
+ */
+class Selecao
+{
+private:
+    vector<uint64_t> vPalavras; ///< Bits das linhas (bit k da palavra p = linha 64 * p + k)
+    size_t iLinhas = 0;         ///< Número de linhas do batch
+
+    // Zera os bits além da última linha
+    void limpaSobra()
+    {
+        if (iLinhas % 64 != 0 && !vPalavras.empty())
+            vPalavras.back() &= (uint64_t(1) << (iLinhas % 64)) - 1;
+    }
+
+public:
+    Selecao() = default;
+
+    /**
+     * @brief Cria uma seleção com todas as linhas marcadas (ou nenhuma).
+     * @param iLinhas Número de linhas do batch.
+     * @param bTodas Se true, marca todas as linhas.
+     */
+    explicit Selecao(size_t iLinhas, bool bTodas = false)
+        : vPalavras((iLinhas + 63) / 64, bTodas ? ~uint64_t(0) : 0), iLinhas(iLinhas)
+    {
+        limpaSobra();
+    }
+
+    /**
+     * @brief Monta a seleção a partir de um teste por linha, em blocos de 64 linhas sem desvios.
+     * @param iLinhas Número de linhas.
+     * @param teste Função (size_t linha) -> bool.
+     */
+    template <typename F>
+    static Selecao deTeste(size_t iLinhas, F &&teste)
+    {
+        Selecao selecao(iLinhas);
+        size_t iCompletas = iLinhas / 64;
+        for (size_t p = 0; p < iCompletas; p++)
+        {
+            uint64_t palavra = 0;
+            size_t base = p * 64;
+            for (size_t k = 0; k < 64; k++)
+                palavra |= uint64_t(teste(base + k) ? 1 : 0) << k;
+            selecao.vPalavras[p] = palavra;
+        }
+        if (iCompletas < selecao.vPalavras.size())
+        {
+            uint64_t palavra = 0;
+            size_t base = iCompletas * 64;
+            for (size_t k = 0; base + k < iLinhas; k++)
+                palavra |= uint64_t(teste(base + k) ? 1 : 0) << k;
+            selecao.vPalavras[iCompletas] = palavra;
+        }
+        return selecao;
+    }
+
+    size_t iGetLinhas() const { return iLinhas; }
+
+    bool bSelecionada(size_t i) const { return (vPalavras[i / 64] >> (i % 64)) & 1; }
+
+    /**
+     * @brief Retorna o número de linhas selecionadas.
+     */
+    size_t contagem() const
+    {
+        size_t total = 0;
+        for (uint64_t palavra : vPalavras)
+            total += __builtin_popcountll(palavra);
+        return total;
+    }
+
+    /**
+     * @brief Chama f(linha) para cada linha selecionada, em ordem crescente.
+     */
+    template <typename F>
+    void paraCada(F &&f) const
+    {
+        for (size_t p = 0; p < vPalavras.size(); p++)
+        {
+            uint64_t palavra = vPalavras[p];
+            while (palavra)
+            {
+                f(p * 64 + __builtin_ctzll(palavra));
+                palavra &= palavra - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Retorna os índices das linhas selecionadas (vetor de seleção).
+     */
+    vector<size_t> indices() const
+    {
+        vector<size_t> vIndices;
+        vIndices.reserve(contagem());
+        paraCada([&](size_t i) { vIndices.push_back(i); });
+        return vIndices;
+    }
+
+    Selecao &operator&=(const Selecao &other)
+    {
+        for (size_t p = 0; p < vPalavras.size() && p < other.vPalavras.size(); p++)
+            vPalavras[p] &= other.vPalavras[p];
+        return *this;
+    }
+
+    Selecao &operator|=(const Selecao &other)
+    {
+        for (size_t p = 0; p < vPalavras.size() && p < other.vPalavras.size(); p++)
+            vPalavras[p] |= other.vPalavras[p];
+        return *this;
+    }
+
+    /**
+     * @brief Inverte a seleção.
+     */
+    void inverte()
+    {
+        for (uint64_t &palavra : vPalavras)
+            palavra = ~palavra;
+        limpaSobra();
+    }
+};
+
+/**
+ * @class Predicado
+ * @brief Condição sobre as colunas de um DataFrame, avaliada coluna a coluna em um bitmap.
+ *
+ * Folhas: igual (coluna = valor), entre (mínimo <= coluna <= máximo) e em (coluna em uma
+ * lista de valores); as folhas são combinadas com &&, || e !. Cada folha lê a coluna
+ * tipada de forma contígua e compara com o valor já convertido para o tipo da coluna,
+ * em laços sem desvios que o compilador vetoriza; colunas codificadas por dicionário
+ * comparam códigos. E/OU/NÃO são operações sobre as palavras do bitmap.
+ */
+class Predicado
+{
+public:
+    enum class Tipo
+    {
+        Igual,
+        Entre,
+        Em,
+        E,
+        Ou,
+        Nao
+    };
+
+private:
+    struct No
+    {
+        Tipo tipo;
+        string strColuna;
+        vector<any> vValores;
+        double dMinimo = 0.0;
+        double dMaximo = 0.0;
+        shared_ptr<const No> esq, dir;
+    };
+
+    shared_ptr<const No> raiz;
+
+    explicit Predicado(shared_ptr<const No> no) : raiz(std::move(no)) {}
+
+    static Predicado composto(Tipo tipo, const Predicado &a, const Predicado *b)
+    {
+        auto no = make_shared<No>();
+        no->tipo = tipo;
+        no->esq = a.raiz;
+        if (b)
+            no->dir = b->raiz;
+        return Predicado(no);
+    }
+
+    // Indica se um valor procurado numa coluna int é um inteiro exato: 2.5 (ou "2.5") não pode
+    // ser convertido para 2, senão igual("x", 2.5) selecionaria as linhas com x == 2
+    static bool bInteiroExato(const any &valor)
+    {
+        const type_info &tipo = valor.type();
+        if (tipo == typeid(double) || tipo == typeid(float))
+        {
+            double d = tipo == typeid(double) ? any_cast<double>(valor) : any_cast<float>(valor);
+            return d == trunc(d) && d >= -9.2e18 && d <= 9.2e18;
+        }
+        if (tipo == typeid(string) || tipo == typeid(const char *))
+        {
+            string_view texto = tipo == typeid(string) ? string_view(any_cast<const string &>(valor))
+                                                       : string_view(any_cast<const char *>(valor));
+            int64_t v;
+            auto [ptr, erro] = from_chars(texto.data(), texto.data() + texto.size(), v);
+            return erro == errc() && ptr == texto.data() + texto.size();
+        }
+        return true;
+    }
+
+    // Converte os valores procurados para o tipo da coluna (valores inconvertíveis, ou que
+    // perderiam parte do valor na conversão para int, são ignorados)
+    static Column valoresNoTipo(const Column &coluna, const vector<any> &vValores)
+    {
+        Column alvo(coluna.strGetName(), coluna.strGetType());
+        for (const auto &valor : vValores)
+        {
+            if (coluna.isInt() && !bInteiroExato(valor))
+                continue;
+            alvo.bAdicionaElemento(valor);
+        }
+        return alvo;
+    }
+
+    // Seleciona as linhas cujo valor está em `alvo` (igualdade e listas IN)
+    static Selecao avaliaEm(const Column &coluna, const Column &alvo)
+    {
+        size_t n = coluna.iGetSize();
+        size_t k = alvo.iGetSize();
+        if (k == 0)
+            return Selecao(n);
+
+        if (coluna.isInt())
+        {
+            const int64_t *dados = coluna.intData().data();
+            const auto &v = alvo.intData();
+            if (k == 1)
+            {
+                int64_t x = v[0];
+                return Selecao::deTeste(n, [&](size_t i) { return dados[i] == x; });
+            }
+            return Selecao::deTeste(n, [&](size_t i)
+                                    { return find(v.begin(), v.end(), dados[i]) != v.end(); });
+        }
+        if (coluna.isDouble())
+        {
+            const double *dados = coluna.doubleData().data();
+            const auto &v = alvo.doubleData();
+            if (k == 1)
+            {
+                double x = v[0];
+                return Selecao::deTeste(n, [&](size_t i) { return dados[i] == x; });
+            }
+            return Selecao::deTeste(n, [&](size_t i)
+                                    { return find(v.begin(), v.end(), dados[i]) != v.end(); });
+        }
+        if (coluna.isBool())
+        {
+            const uint8_t *dados = coluna.boolData().data();
+            bool bTrue = false, bFalse = false;
+            for (size_t j = 0; j < k; j++)
+                (alvo.getBool(j) ? bTrue : bFalse) = true;
+            return Selecao::deTeste(n, [&](size_t i) { return dados[i] ? bTrue : bFalse; });
+        }
+        if (coluna.isDictionary())
+        {
+            // Procura os códigos dos valores uma vez; valores fora do dicionário não aparecem na coluna
+            vector<uint32_t> vCodigos;
+            for (size_t j = 0; j < k; j++)
+            {
+                uint32_t codigo;
+                if (coluna.dictionary()->bBusca(alvo.getString(j), codigo))
+                    vCodigos.push_back(codigo);
+            }
+            if (vCodigos.empty())
+                return Selecao(n);
+            const uint32_t *dados = coluna.codeData().data();
+            if (vCodigos.size() == 1)
+            {
+                uint32_t x = vCodigos[0];
+                return Selecao::deTeste(n, [&](size_t i) { return dados[i] == x; });
+            }
+            return Selecao::deTeste(n, [&](size_t i)
+                                    { return find(vCodigos.begin(), vCodigos.end(), dados[i]) != vCodigos.end(); });
+        }
+        if (k == 1)
+        {
+            string_view x = alvo.getString(0);
+            return Selecao::deTeste(n, [&](size_t i) { return coluna.getString(i) == x; });
+        }
+        unordered_set<string_view> setValores;
+        for (size_t j = 0; j < k; j++)
+            setValores.insert(alvo.getString(j));
+        return Selecao::deTeste(n, [&](size_t i) { return setValores.count(coluna.getString(i)) > 0; });
+    }
+
+    // Seleciona as linhas com dMinimo <= valor <= dMaximo
+    static Selecao avaliaEntre(const Column &coluna, double dMinimo, double dMaximo)
+    {
+        size_t n = coluna.iGetSize();
+        if (coluna.isDouble())
+        {
+            const double *dados = coluna.doubleData().data();
+            return Selecao::deTeste(n, [&](size_t i) { return (dados[i] >= dMinimo) & (dados[i] <= dMaximo); });
+        }
+        if (coluna.isInt())
+        {
+            const int64_t *dados = coluna.intData().data();
+            return Selecao::deTeste(n, [&](size_t i)
+                                    { double d = static_cast<double>(dados[i]); return (d >= dMinimo) & (d <= dMaximo); });
+        }
+        // Strings (e bools) são comparadas como números, como em Expr
+        vector<double> vdValores = coluna.toDoubleVector();
+        const double *dados = vdValores.data();
+        return Selecao::deTeste(n, [&](size_t i) { return (dados[i] >= dMinimo) & (dados[i] <= dMaximo); });
+    }
+
+    // Resultados já calculados de cada nó, compartilhados entre predicados avaliados juntos
+    using Memo = unordered_map<const No *, Selecao>;
+
+    static Selecao avalia(const No *no, const vector<string> &vstrNomes, const vector<Column> &colunas, Memo *memo)
+    {
+        if (memo)
+        {
+            auto it = memo->find(no);
+            if (it != memo->end())
+                return it->second;
+        }
+        Selecao selecao = avaliaNo(no, vstrNomes, colunas, memo);
+        if (memo)
+            memo->emplace(no, selecao);
+        return selecao;
+    }
+
+    static Selecao avaliaNo(const No *no, const vector<string> &vstrNomes, const vector<Column> &colunas, Memo *memo)
+    {
+        switch (no->tipo)
+        {
+        case Tipo::E:
+        {
+            Selecao selecao = avalia(no->esq.get(), vstrNomes, colunas, memo);
+            if (selecao.contagem() > 0)
+                selecao &= avalia(no->dir.get(), vstrNomes, colunas, memo);
+            return selecao;
+        }
+        case Tipo::Ou:
+        {
+            Selecao selecao = avalia(no->esq.get(), vstrNomes, colunas, memo);
+            selecao |= avalia(no->dir.get(), vstrNomes, colunas, memo);
+            return selecao;
+        }
+        case Tipo::Nao:
+        {
+            Selecao selecao = avalia(no->esq.get(), vstrNomes, colunas, memo);
+            selecao.inverte();
+            return selecao;
+        }
+        default:
+            break;
+        }
+
+        auto it = find(vstrNomes.begin(), vstrNomes.end(), no->strColuna);
+        if (it == vstrNomes.end())
+        {
+            throw invalid_argument("Coluna '" + no->strColuna + "' não encontrada.");
+        }
+        const Column &coluna = colunas[distance(vstrNomes.begin(), it)];
+        if (no->tipo == Tipo::Entre)
+            return avaliaEntre(coluna, no->dMinimo, no->dMaximo);
+        return avaliaEm(coluna, valoresNoTipo(coluna, no->vValores));
+    }
+
+public:
+    /**
+     * @brief Linhas em que a coluna é igual ao valor (convertido para o tipo da coluna).
+     */
+    static Predicado igual(const string &strColuna, const any &valor)
+    {
+        auto no = make_shared<No>();
+        no->tipo = Tipo::Igual;
+        no->strColuna = strColuna;
+        no->vValores = {valor};
+        return Predicado(no);
+    }
+
+    /**
+     * @brief Linhas em que a coluna está entre dMinimo e dMaximo, inclusive.
+     */
+    static Predicado entre(const string &strColuna, double dMinimo, double dMaximo)
+    {
+        auto no = make_shared<No>();
+        no->tipo = Tipo::Entre;
+        no->strColuna = strColuna;
+        no->dMinimo = dMinimo;
+        no->dMaximo = dMaximo;
+        return Predicado(no);
+    }
+
+    /**
+     * @brief Linhas em que a coluna é igual a algum dos valores (IN).
+     */
+    static Predicado em(const string &strColuna, const vector<any> &vValores)
+    {
+        auto no = make_shared<No>();
+        no->tipo = Tipo::Em;
+        no->strColuna = strColuna;
+        no->vValores = vValores;
+        return Predicado(no);
+    }
+
+    friend Predicado operator&&(const Predicado &a, const Predicado &b) { return composto(Tipo::E, a, &b); }
+    friend Predicado operator||(const Predicado &a, const Predicado &b) { return composto(Tipo::Ou, a, &b); }
+    friend Predicado operator!(const Predicado &a) { return composto(Tipo::Nao, a, nullptr); }
+
+    /**
+     * @brief Avalia o predicado sobre todas as linhas.
+     * @param vstrNomes Nomes das colunas do DataFrame.
+     * @param colunas Colunas do DataFrame.
+     * @return Bitmap das linhas que satisfazem o predicado.
+     * @throw invalid_argument Se alguma coluna referenciada não existir.
+     */
+    Selecao avaliar(const vector<string> &vstrNomes, const vector<Column> &colunas) const
+    {
+        return avalia(raiz.get(), vstrNomes, colunas, nullptr);
+    }
+
+    /**
+     * @brief Avalia vários predicados sobre as mesmas colunas de uma só vez.
+     *
+     * Subexpressões compartilhadas (o mesmo objeto Predicado usado em mais de um predicado,
+     * como `p` e `!p`) são avaliadas uma única vez.
+     * @param vPredicados Predicados a serem avaliados.
+     * @param vstrNomes Nomes das colunas do DataFrame.
+     * @param colunas Colunas do DataFrame.
+     * @return Um bitmap por predicado, na mesma ordem.
+     * @throw invalid_argument Se alguma coluna referenciada não existir.
+     */
+    static vector<Selecao> avaliarJuntos(const vector<Predicado> &vPredicados, const vector<string> &vstrNomes,
+                                         const vector<Column> &colunas)
+    {
+        Memo memo;
+        vector<Selecao> vSelecoes;
+        vSelecoes.reserve(vPredicados.size());
+        for (const auto &predicado : vPredicados)
+            vSelecoes.push_back(avalia(predicado.raiz.get(), vstrNomes, colunas, &memo));
+        return vSelecoes;
+    }
+};
+
+#endif // PREDICATE_H
@@ -0,0 +1,373 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "TaskQueue.h"
+
+// Etapa do pipeline (extrator, transformador ou carregador) vista pelo escalonador
+//
+// Em vez de ter uma thread própria bloqueada nos buffers, a etapa implementa pump(), que faz
+// todo o trabalho disponível sem bloquear (retira as entradas prontas e cria as tarefas
+// enquanto há vaga nas saídas) e retorna. O escalonador chama pump() numa tarefa da pool
+// sempre que a etapa é acordada: chegaram dados ou uma entrada terminou, um consumidor
+// liberou uma vaga na saída, ou a última tarefa pendente da etapa terminou.
+class Stage
+{
+private:
+    std::function<void()> wake;       // Pede ao escalonador uma nova chamada de pump
+    std::atomic<int> runningTasks{0}; // Tarefas da etapa enfileiradas e ainda não concluídas
+    std::atomic<int> currentPriority{0}; // Prioridade das tarefas da etapa (ver SchedulingPolicy)
+
+protected:
+    // Contagem das tarefas da etapa: taskCreated antes de enfileirar, taskDone no fim da tarefa
+    void taskCreated() { runningTasks.fetch_add(1); }
+
+    void taskDone()
+    {
+        // A etapa pode estar esperando as tarefas acabarem para terminar
+        if (runningTasks.fetch_sub(1) == 1)
+        {
+            wakeUp();
+        }
+    }
+
+    bool hasRunningTasks() const { return runningTasks.load() > 0; }
+
+    // Prioridade com que as tarefas da etapa devem ser enfileiradas (TaskQueue::push_task)
+    int priority() const { return currentPriority.load(std::memory_order_relaxed); }
+
+public:
+    virtual ~Stage() = default;
+
+    /**
+     * Faz o trabalho disponível sem bloquear.
+     * Nunca é chamado por duas threads ao mesmo tempo para a mesma etapa.
+     * @return true quando a etapa terminou: entradas esgotadas, tarefas concluídas e saídas fechadas
+     */
+    virtual bool pump() = 0;
+
+    // Setters da função de despertar e da prioridade (definidas pelo escalonador)
+    void setWake(std::function<void()> f) { wake = std::move(f); }
+    void setPriority(int p) { currentPriority.store(p, std::memory_order_relaxed); }
+
+    // Pede uma nova chamada de pump (chamado pelos buffers ligados à etapa)
+    void wakeUp()
+    {
+        if (wake)
+        {
+            wake();
+        }
+    }
+};
+
+// Situação de uma etapa no grafo do pipeline, usada para calcular a prioridade das tarefas
+struct StageInfo
+{
+    int distanceToSink = 0;     // Arestas até o loader mais próximo (0 para os loaders)
+    int longestPathToSink = 0;  // Arestas até o loader mais distante (caminho crítico)
+    double inputOccupancy = 0;  // Ocupação (0 a 1) do buffer de entrada mais cheio
+    double outputOccupancy = 0; // Ocupação (0 a 1) do buffer de saída mais cheio
+    int levels = 1;             // Níveis de prioridade da fila de tarefas
+};
+
+// Política de escalonamento: define a prioridade das tarefas de cada etapa
+//
+// A prioridade é recalculada toda vez que a etapa é despachada e vale para a chamada de
+// pump e para as tarefas criadas por ela. Vai de 0 (mais baixa) a info.levels - 1; a fila
+// de tarefas sempre executa primeiro as tarefas de prioridade mais alta.
+class SchedulingPolicy
+{
+public:
+    virtual ~SchedulingPolicy() = default;
+    virtual int priority(const StageInfo &info) const = 0;
+};
+
+// Todas as tarefas com a mesma prioridade (ordem de chegada)
+class FifoPolicy : public SchedulingPolicy
+{
+public:
+    int priority(const StageInfo &) const override { return 0; }
+};
+
+// Favorece as etapas mais próximas do fim do pipeline: um batch que já foi extraído é
+// levado até o loader antes que novos batches sejam extraídos, o que reduz a latência
+// de cada batch e a memória ocupada pelos buffers intermediários
+class SinkFirstPolicy : public SchedulingPolicy
+{
+public:
+    int priority(const StageInfo &info) const override
+    {
+        return std::max(info.levels - 1 - info.distanceToSink, 0);
+    }
+};
+
+// Caminho crítico: favorece as etapas com o caminho mais longo até o fim do pipeline, que
+// limitam o tempo total de execução (não a latência de cada batch)
+class CriticalPathPolicy : public SchedulingPolicy
+{
+public:
+    int priority(const StageInfo &info) const override
+    {
+        return std::min(info.longestPathToSink, info.levels - 1);
+    }
+};
+
+// Como SinkFirstPolicy, mas dá a prioridade máxima a quem consome um buffer quase cheio,
+// para desafogar o buffer antes que a etapa anterior fique bloqueada
+class BackpressurePolicy : public SinkFirstPolicy
+{
+private:
+    double threshold;
+
+public:
+    /**
+     * @param threshold - ocupação (0 a 1) de um buffer de entrada a partir da qual a etapa é priorizada
+     */
+    explicit BackpressurePolicy(double threshold = 0.5) : threshold(threshold) {}
+
+    int priority(const StageInfo &info) const override
+    {
+        if (info.inputOccupancy >= threshold)
+        {
+            return info.levels - 1;
+        }
+        return SinkFirstPolicy::priority(info);
+    }
+};
+
+// Classe do escalonador das etapas do pipeline
+//
+// Conhece as etapas (as arestas do grafo são os buffers, ligados pelo Manager com
+// Buffer::on_data/on_space) e despacha cada chamada de pump como uma tarefa na pool
+// compartilhada. Assim o pipeline roda só com as threads da pool, qualquer que seja o
+// número de etapas. Cada etapa tem um estado atômico que garante que há no máximo uma
+// chamada de pump dela na fila ou em execução; um despertar recebido durante a execução
+// faz a etapa ser despachada de novo ao fim da chamada atual.
+// Cada despacho usa a prioridade definida pela política de escalonamento (ver setPolicy).
+class Scheduler
+{
+private:
+    enum State : int
+    {
+        Idle,     // Esperando ser acordada
+        Queued,   // pump enfileirado
+        Running,  // pump em execução
+        Rerun,    // pump em execução e acordada de novo nesse meio-tempo
+        Finished  // Etapa terminada
+    };
+
+    struct Entry
+    {
+        Stage *stage;
+        std::atomic<int> state{Idle};
+        std::vector<Entry *> consumers;                  // Etapas que consomem as saídas desta
+        std::vector<std::function<double()>> inputs;     // Ocupação de cada buffer de entrada
+        std::vector<std::function<double()>> outputs;    // Ocupação de cada buffer de saída
+        StageInfo info;                                  // Distâncias calculadas em start()
+    };
+
+    TaskQueue *taskqueue;
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::atomic<int> activeStages{0}; // Etapas ainda não terminadas
+    std::shared_ptr<SchedulingPolicy> policy = std::make_shared<FifoPolicy>();
+
+    Entry *find(Stage *stage)
+    {
+        for (auto &entry : entries)
+        {
+            if (entry->stage == stage)
+            {
+                return entry.get();
+            }
+        }
+        return nullptr;
+    }
+
+    static double maxOccupancy(const std::vector<std::function<double()>> &buffers)
+    {
+        double occupancy = 0;
+        for (const auto &buffer : buffers)
+        {
+            occupancy = std::max(occupancy, buffer());
+        }
+        return occupancy;
+    }
+
+    // Calcula a menor e a maior distância de cada etapa até um loader (o grafo não tem ciclos)
+    void computeDistances()
+    {
+        for (auto &entry : entries)
+        {
+            entry->info.distanceToSink = -1;
+        }
+        bool changed = true;
+        for (size_t round = 0; changed && round <= entries.size(); round++)
+        {
+            changed = false;
+            for (auto &entry : entries)
+            {
+                int shortest = entry->consumers.empty() ? 0 : -1;
+                int longest = 0;
+                for (Entry *consumer : entry->consumers)
+                {
+                    if (consumer->info.distanceToSink < 0)
+                    {
+                        continue;
+                    }
+                    int d = consumer->info.distanceToSink + 1;
+                    shortest = shortest < 0 ? d : std::min(shortest, d);
+                    longest = std::max(longest, consumer->info.longestPathToSink + 1);
+                }
+                if (shortest != entry->info.distanceToSink || longest != entry->info.longestPathToSink)
+                {
+                    entry->info.distanceToSink = shortest;
+                    entry->info.longestPathToSink = longest;
+                    changed = true;
+                }
+            }
+        }
+        for (auto &entry : entries)
+        {
+            entry->info.distanceToSink = std::max(entry->info.distanceToSink, 0);
+            entry->info.levels = taskqueue->numPriorities();
+        }
+    }
+
+    void dispatch(Entry *entry)
+    {
+        StageInfo info = entry->info;
+        info.inputOccupancy = maxOccupancy(entry->inputs);
+        info.outputOccupancy = maxOccupancy(entry->outputs);
+        int priority = std::clamp(policy->priority(info), 0, info.levels - 1);
+
+        entry->stage->setPriority(priority);
+        taskqueue->push_task([this, entry]()
+                             { runStage(entry); }, priority);
+    }
+
+    void activate(Entry *entry)
+    {
+        int state = entry->state.load();
+        while (true)
+        {
+            if (state == Idle)
+            {
+                if (entry->state.compare_exchange_weak(state, Queued))
+                {
+                    dispatch(entry);
+                    return;
+                }
+            }
+            else if (state == Running)
+            {
+                if (entry->state.compare_exchange_weak(state, Rerun))
+                {
+                    return;
+                }
+            }
+            else
+            {
+                // Já enfileirada, já marcada para rodar de novo ou terminada
+                return;
+            }
+        }
+    }
+
+    void runStage(Entry *entry)
+    {
+        entry->state.store(Running);
+        if (entry->stage->pump())
+        {
+            entry->state.store(Finished);
+            if (activeStages.fetch_sub(1) == 1)
+            {
+                activeStages.notify_all();
+            }
+            return;
+        }
+
+        // Se foi acordada durante a chamada, volta para a fila em vez de dormir
+        int state = Running;
+        if (!entry->state.compare_exchange_strong(state, Idle))
+        {
+            entry->state.store(Queued);
+            dispatch(entry);
+        }
+    }
+
+public:
+    explicit Scheduler(TaskQueue *tq) : taskqueue(tq) {}
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    /**
+     * Registra uma etapa. Deve ser chamado antes de start().
+     */
+    void addStage(Stage *stage)
+    {
+        entries.push_back(std::make_unique<Entry>());
+        Entry *entry = entries.back().get();
+        entry->stage = stage;
+        stage->setWake([this, entry]()
+                       { activate(entry); });
+        activeStages.fetch_add(1);
+    }
+
+    /**
+     * Registra uma aresta do grafo: um buffer produzido por `producer` e consumido por `consumer`.
+     * Deve ser chamado depois de addStage das duas etapas e antes de start().
+     * @param occupancy - função que retorna a ocupação atual (0 a 1) do buffer
+     */
+    void addEdge(Stage *producer, Stage *consumer, std::function<double()> occupancy)
+    {
+        Entry *from = find(producer);
+        Entry *to = find(consumer);
+        if (from && to)
+        {
+            from->consumers.push_back(to);
+            from->outputs.push_back(occupancy);
+            to->inputs.push_back(std::move(occupancy));
+        }
+    }
+
+    // Setter da política de escalonamento (padrão: FifoPolicy); deve ser chamado antes de start()
+    void setPolicy(std::shared_ptr<SchedulingPolicy> p)
+    {
+        if (p)
+        {
+            policy = std::move(p);
+        }
+    }
+
+    /**
+     * Despacha a primeira chamada de pump de todas as etapas.
+     */
+    void start()
+    {
+        computeDistances();
+        for (auto &entry : entries)
+        {
+            activate(entry.get());
+        }
+    }
+
+    /**
+     * Bloqueia a thread (sem girar) até que todas as etapas tenham terminado.
+     */
+    void wait()
+    {
+        int active = activeStages.load();
+        while (active > 0)
+        {
+            activeStages.wait(active);
+            active = activeStages.load();
+        }
+    }
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,175 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <functional>
+
+using namespace std;
+
+/**
+ * @class StringInterner
+ * @brief Dicionário thread-safe que associa cada string distinta a um código uint32_t.
+ *
+ * Usado pelas colunas codificadas por dicionário (Column::dicionario): cada célula guarda
+ * apenas o código, e todos os batches que compartilham o mesmo StringInterner usam os mesmos
+ * códigos, de modo que comparar valores é comparar inteiros.
+ *
+ * As strings ficam em blocos de tamanho fixo que nunca são realocados, então os
+ * string_view devolvidos por texto() continuam válidos enquanto o dicionário existir e a
+ * leitura de um código já obtido não precisa de lock. O hash de cada string é calculado
+ * uma vez, na inserção, com o mesmo hash usado pelas colunas de strings comuns.
+ */
+class StringInterner
+{
+private:
+    struct Entrada
+    {
+        string str;
+        uint64_t hash = 0;
+    };
+
+    static constexpr uint32_t kBitsBloco = 14;
+    static constexpr uint32_t kTamanhoBloco = 1u << kBitsBloco;
+    static constexpr uint32_t kMaxBlocos = 1u << 14;
+
+    unique_ptr<atomic<Entrada *>[]> blocos;            ///< Blocos de entradas, alocados sob demanda
+    unordered_map<string_view, uint32_t> umapCodigos;  ///< String -> código (as chaves apontam para os blocos)
+    mutable shared_mutex mtx;                          ///< Protege umapCodigos e a criação de entradas
+    atomic<uint32_t> iTamanho{0};                      ///< Número de strings distintas
+
+    const Entrada &entrada(uint32_t iCodigo) const
+    {
+        return blocos[iCodigo >> kBitsBloco].load(memory_order_acquire)[iCodigo & (kTamanhoBloco - 1)];
+    }
+
+public:
+    /**
+     * @class Cache
+     * @brief Cache local (de uma única thread) na frente de um StringInterner.
+     *
+     * Evita tomar o lock compartilhado do dicionário a cada célula quando um batch repete
+     * poucos valores distintos. As chaves apontam para as strings do próprio dicionário.
+     */
+    class Cache
+    {
+    private:
+        StringInterner &dicionario;
+        unordered_map<string_view, uint32_t> umapCodigos;
+
+    public:
+        explicit Cache(StringInterner &dicionario) : dicionario(dicionario) {}
+
+        /**
+         * @brief Retorna o código de uma string, inserindo-a no dicionário se necessário.
+         * @param strValor String a ser codificada.
+         */
+        uint32_t codigo(string_view strValor)
+        {
+            auto it = umapCodigos.find(strValor);
+            if (it != umapCodigos.end())
+                return it->second;
+            uint32_t iCodigo = dicionario.codigo(strValor);
+            umapCodigos.emplace(dicionario.texto(iCodigo), iCodigo);
+            return iCodigo;
+        }
+    };
+
+    StringInterner() : blocos(new atomic<Entrada *>[kMaxBlocos])
+    {
+        for (uint32_t i = 0; i < kMaxBlocos; i++)
+            blocos[i].store(nullptr, memory_order_relaxed);
+    }
+
+    ~StringInterner()
+    {
+        for (uint32_t i = 0; i < kMaxBlocos; i++)
+            delete[] blocos[i].load(memory_order_relaxed);
+    }
+
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    /**
+     * @brief Retorna o código de uma string, inserindo-a no dicionário se for nova.
+     * @param strValor String a ser codificada.
+     * @return Código da string.
+     * @throw length_error Se o dicionário estiver cheio.
+     */
+    uint32_t codigo(string_view strValor)
+    {
+        {
+            shared_lock<shared_mutex> lock(mtx);
+            auto it = umapCodigos.find(strValor);
+            if (it != umapCodigos.end())
+                return it->second;
+        }
+
+        unique_lock<shared_mutex> lock(mtx);
+        auto it = umapCodigos.find(strValor);
+        if (it != umapCodigos.end())
+            return it->second;
+
+        uint32_t iCodigo = iTamanho.load(memory_order_relaxed);
+        uint32_t iBloco = iCodigo >> kBitsBloco;
+        if (iBloco >= kMaxBlocos)
+        {
+            throw length_error("Dicionário de strings cheio.");
+        }
+        Entrada *bloco = blocos[iBloco].load(memory_order_relaxed);
+        if (bloco == nullptr)
+        {
+            bloco = new Entrada[kTamanhoBloco];
+            blocos[iBloco].store(bloco, memory_order_release);
+        }
+
+        Entrada &nova = bloco[iCodigo & (kTamanhoBloco - 1)];
+        nova.str.assign(strValor.data(), strValor.size());
+        nova.hash = hash<string_view>{}(nova.str);
+        umapCodigos.emplace(string_view(nova.str), iCodigo);
+        iTamanho.store(iCodigo + 1, memory_order_release);
+        return iCodigo;
+    }
+
+    /**
+     * @brief Procura o código de uma string sem inseri-la.
+     * @param strValor String procurada.
+     * @param iCodigo Saída: código da string, se existir.
+     * @return true se a string estiver no dicionário.
+     */
+    bool bBusca(string_view strValor, uint32_t &iCodigo) const
+    {
+        shared_lock<shared_mutex> lock(mtx);
+        auto it = umapCodigos.find(strValor);
+        if (it == umapCodigos.end())
+            return false;
+        iCodigo = it->second;
+        return true;
+    }
+
+    /**
+     * @brief Retorna a string de um código (válida enquanto o dicionário existir).
+     * @param iCodigo Código obtido deste dicionário.
+     */
+    string_view texto(uint32_t iCodigo) const { return entrada(iCodigo).str; }
+
+    /**
+     * @brief Retorna o hash (std::hash<string_view>) da string de um código.
+     * @param iCodigo Código obtido deste dicionário.
+     */
+    uint64_t hashDe(uint32_t iCodigo) const { return entrada(iCodigo).hash; }
+
+    /**
+     * @brief Retorna o número de strings distintas no dicionário.
+     */
+    size_t tamanho() const { return iTamanho.load(memory_order_acquire); }
+};
+
+#endif // STRINGINTERNER_H
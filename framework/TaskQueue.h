@@ -3,61 +3,237 @@
 
 #include <iostream>
 #include <queue>
+#include <deque>
 #include <vector>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <atomic>
-#include "Semaphore.h"
+#include <algorithm>
+#include "WorkStealingDeque.h"
 
 // Classe responsável por gerenciar a fila de tarefas que serão executadas por múltiplas threads
+//
+// Funciona com roubo de tarefas (work stealing): cada thread da pool, registrada com
+// registerWorker, tem um deque próprio, e há uma fila global para as tarefas criadas
+// fora da pool. Tarefas criadas por uma thread da pool vão para o deque dela; quando uma
+// thread fica sem trabalho local, consome a fila global e depois rouba dos deques das
+// outras, de modo que as threads não disputam um único mutex a cada tarefa.
+//
+// As tarefas têm prioridade: há uma faixa (fila global + deques) por nível de prioridade,
+// e uma thread só pega tarefas de uma faixa quando todas as faixas mais altas estão vazias.
+// Com um único nível (o padrão), o comportamento é o de uma fila sem prioridades.
 class TaskQueue
 {
 private:
-    std::queue<std::function<void()>> tasks; // Fila de tarefas como funções sem argumentos
-    std::mutex mtx;                          // Mutex para proteger o acesso à fila
-    std::condition_variable cond;            // Variável de condição para controlar o bloqueio/espera
-    bool finishedWork = false;               // Indica se o sistema está encerrando as tarefas
-    Semaphore numberOfLoaders;               // Semáforo que representa quantos loaders ainda estão ativos
-    std::mutex nOfLoadersMtx;                // Mutex para proteger o acesso à fila
+    using Task = std::function<void()>;
+
+    // Tarefas de um nível de prioridade
+    struct Lane
+    {
+        std::deque<Task> tasks;              // Fila global, para tarefas criadas fora da pool
+        std::mutex globalMtx;                // Mutex para proteger o acesso à fila global
+        std::vector<std::unique_ptr<WorkStealingDeque<Task *>>> localQueues; // Um deque por thread da pool
+        std::atomic<int> pending{0};         // Tarefas enfileiradas nesta faixa e ainda não retiradas
+    };
+
+    std::vector<std::unique_ptr<Lane>> lanes; // Uma faixa por nível, do menos (0) ao mais prioritário
+    int workers = 0;                          // Número de threads da pool
+
+    std::atomic<int> pendingTasks{0};        // Número de tarefas enfileiradas e ainda não retiradas
+    std::atomic<int> sleepingWorkers{0};     // Número de threads dormindo à espera de tarefas
+
+    std::mutex mtx;                          // Mutex usado para dormir/acordar as threads
+    std::condition_variable workCond;        // Variável de condição em que as threads da pool esperam por tarefas
+    std::atomic<bool> finishedWork{false};   // Indica se o sistema está encerrando as tarefas
+
+    // Identifica a thread atual como uma thread da pool de alguma TaskQueue
+    struct WorkerInfo
+    {
+        TaskQueue *owner = nullptr;
+        int index = -1;
+    };
+
+    static WorkerInfo &currentWorker()
+    {
+        static thread_local WorkerInfo info;
+        return info;
+    }
+
+    // Índice do deque da thread atual, ou -1 se ela não pertencer à pool desta fila
+    int localIndex()
+    {
+        WorkerInfo &info = currentWorker();
+        return info.owner == this ? info.index : -1;
+    }
+
+    // Desconta tarefas retiradas da fila, acordando quem espera em waitEmpty quando ela esvazia
+    void taken(int n)
+    {
+        if (n > 0 && pendingTasks.fetch_sub(n) == n)
+        {
+            pendingTasks.notify_all();
+        }
+    }
+
+    // Tenta obter uma tarefa de uma faixa sem bloquear: deque local, fila global e, por fim, roubo
+    bool tryTakeFrom(Lane &lane, int self, Task &task)
+    {
+        Task *ptr = nullptr;
+
+        if (self >= 0 && lane.localQueues[self]->pop(ptr))
+        {
+            task = std::move(*ptr);
+            delete ptr;
+            return true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(lane.globalMtx);
+            if (!lane.tasks.empty())
+            {
+                task = std::move(lane.tasks.front());
+                lane.tasks.pop_front();
+                return true;
+            }
+        }
+
+        // Começa pela thread vizinha para espalhar os roubos entre as vítimas
+        int n = static_cast<int>(lane.localQueues.size());
+        for (int k = 1; k <= n; k++)
+        {
+            int victim = ((self < 0 ? 0 : self) + k) % n;
+            if (victim != self && lane.localQueues[victim]->steal(ptr))
+            {
+                task = std::move(*ptr);
+                delete ptr;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Tenta obter a tarefa mais prioritária sem bloquear, pulando as faixas vazias
+    bool tryTake(Task &task)
+    {
+        int self = localIndex();
+        for (int level = static_cast<int>(lanes.size()) - 1; level >= 0; level--)
+        {
+            Lane &lane = *lanes[level];
+            if (lane.pending.load() > 0 && tryTakeFrom(lane, self, task))
+            {
+                lane.pending.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
 
 public:
+    /**
+     * Construtor.
+     * @param numWorkers - número de threads da pool (cada uma recebe um deque próprio por nível)
+     * @param numPriorities - número de níveis de prioridade (ver push_task)
+     */
+    explicit TaskQueue(int numWorkers = 0, int numPriorities = 1) : workers(numWorkers)
+    {
+        for (int level = 0; level < std::max(numPriorities, 1); level++)
+        {
+            lanes.push_back(std::make_unique<Lane>());
+            for (int i = 0; i < numWorkers; i++)
+            {
+                lanes.back()->localQueues.push_back(std::make_unique<WorkStealingDeque<Task *>>());
+            }
+        }
+    }
+
+    ~TaskQueue()
+    {
+        shutdown();
+    }
+
+    /**
+     * Registra a thread atual como a thread de índice `index` da pool.
+     * Deve ser chamado pela própria thread, antes de começar a retirar tarefas.
+     */
+    void registerWorker(int index)
+    {
+        if (index >= 0 && index < workers)
+        {
+            currentWorker() = WorkerInfo{this, index};
+        }
+    }
+
+    /**
+     * Retorna o índice da thread atual na pool desta fila, ou -1 se ela não for da pool.
+     */
+    int currentWorkerIndex() { return localIndex(); }
+
+    // Getters do número de threads da pool e de níveis de prioridade
+    int numWorkers() const { return workers; }
+    int numPriorities() const { return static_cast<int>(lanes.size()); }
+
     /**
      * Adiciona uma nova tarefa à fila.
      * A tarefa é uma função (lambda, função normal ou membro).
+     * Se quem chama é uma thread da pool, a tarefa vai para o deque dela.
+     * @param priority - nível de prioridade (0 = mais baixo), limitado aos níveis da fila
      */
-    void push_task(std::function<void()> task)
+    void push_task(std::function<void()> task, int priority = 0)
     {
+        Lane &lane = *lanes[std::clamp(priority, 0, numPriorities() - 1)];
+        int self = localIndex();
+        if (self >= 0)
         {
-            std::lock_guard<std::mutex> lock(mtx); // Garante exclusão mútua ao acessar a fila
-            tasks.push(task);                      // Adiciona a tarefa à fila
+            lane.localQueues[self]->push(new Task(std::move(task)));
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(lane.globalMtx);
+            lane.tasks.push_back(std::move(task));
+        }
+        lane.pending.fetch_add(1);
+        pendingTasks.fetch_add(1);
+
+        // Acorda uma thread que estiver esperando por uma tarefa
+        if (sleepingWorkers.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            workCond.notify_one();
         }
-        cond.notify_one(); // Acorda uma thread que estiver esperando por uma tarefa
     }
 
     /**
-     * Retira e retorna uma tarefa da fila. 
+     * Retira e retorna uma tarefa da fila.
      * Bloqueia a thread se a fila estiver vazia e ainda houver trabalho a ser feito.
      * Se o sistema estiver finalizando e a fila estiver vazia, retorna uma função vazia.
      */
     std::function<void()> pop_task()
     {
-        std::unique_lock<std::mutex> lock(mtx);
-        cond.wait(lock, [this] {
-            return !tasks.empty() || finishedWork; // Espera enquanto a fila está vazia e o trabalho não terminou
-        });
-
-        // Se estiver finalizando e a fila estiver vazia, retorna uma função nula (shutdown)
-        if (finishedWork && tasks.empty())
+        Task task;
+        while (true)
         {
-            return std::function<void()>(); // Indica que não há mais tarefas
-        }
+            if (pendingTasks.load() > 0 && tryTake(task))
+            {
+                taken(1);
+                return task;
+            }
+
+            std::unique_lock<std::mutex> lock(mtx);
+            sleepingWorkers.fetch_add(1);
+            workCond.wait(lock, [this] {
+                return pendingTasks.load() > 0 || finishedWork.load(); // Espera enquanto não há tarefas e o trabalho não terminou
+            });
+            sleepingWorkers.fetch_sub(1);
 
-        // Retira a tarefa da fila
-        std::function<void()> task = tasks.front();
-        tasks.pop();
-        return task;
+            // Se estiver finalizando e a fila estiver vazia, retorna uma função nula (shutdown)
+            if (finishedWork.load() && pendingTasks.load() == 0)
+            {
+                return std::function<void()>(); // Indica que não há mais tarefas
+            }
+        }
     }
 
     /**
@@ -68,57 +244,59 @@ public:
         {
             std::lock_guard<std::mutex> lock(mtx);
             finishedWork = true;          // Marca que o sistema está finalizando
-            while (!is_empty()) {
-                tasks.pop();              // Limpa as tarefas restantes
+        }
+
+        // Limpa as tarefas restantes
+        for (auto &lane : lanes)
+        {
+            {
+                std::lock_guard<std::mutex> lock(lane->globalMtx);
+                lane->pending.fetch_sub(static_cast<int>(lane->tasks.size()));
+                taken(static_cast<int>(lane->tasks.size()));
+                lane->tasks.clear();
+            }
+            for (auto &local : lane->localQueues)
+            {
+                Task *ptr = nullptr;
+                while (local->steal(ptr))
+                {
+                    delete ptr;
+                    lane->pending.fetch_sub(1);
+                    taken(1);
+                }
             }
         }
-        cond.notify_all();                // Acorda todas as threads esperando
+
+        workCond.notify_all();            // Acorda todas as threads esperando
     }
 
     /**
-     * Retorna se a fila está vazia.
-     * ATENÇÃO: falta de proteção por mutex aqui pode causar condições de corrida se for usada externamente.
+     * Retorna se não há tarefas enfileiradas (tarefas já retiradas podem estar em execução).
      */
     bool is_empty()
     {
-        return tasks.empty();
-    }
-
-    /**
-     * Verifica se o sistema está em modo de finalização.
-     */
-    bool isShutdown() { 
-        std::lock_guard<std::mutex> lock(mtx);
-        return finishedWork;
+        return pendingTasks.load() == 0;
     }
 
     /**
-     * Retorna uma referência ao semáforo que controla os loaders.
+     * Bloqueia a thread (sem girar) até que não haja tarefas enfileiradas.
      */
-    Semaphore& getNumberOfLoaders() {
-        std::lock_guard<std::mutex> lock(nOfLoadersMtx);
-        return numberOfLoaders;
-    }
-
-    /**
-     * Espera até que todos os loaders tenham terminado de adicionar tarefas.
-     */
-    void waitLoadersFinish()
+    void waitEmpty()
     {
-        std::unique_lock<std::mutex> lock(nOfLoadersMtx);
-        cond.wait(lock, [this] {
-            return numberOfLoaders.get_count() == 0;
-        });
+        int pendentes = pendingTasks.load();
+        while (pendentes > 0)
+        {
+            pendingTasks.wait(pendentes);
+            pendentes = pendingTasks.load();
+        }
     }
 
     /**
-     * Acorda todas as threads que estiverem esperando na fila.
-     * Pode ser usado para encerrar loops em outros componentes.
+     * Verifica se o sistema está em modo de finalização.
      */
-    void notifyAll()
-    {
-        cond.notify_all();
+    bool isShutdown() {
+        return finishedWork.load();
     }
 };
 
-#endif
\ No newline at end of file
+#endif
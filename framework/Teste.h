@@ -0,0 +1,36 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+#include <iostream>
+#include <string>
+
+// Verificações usadas pelos programas de teste (Teste*.cpp)
+//
+// Cada programa chama verifica para cada condição e termina com `return resultadoDosTestes();`,
+// que imprime OK ou o número de falhas e retorna o código de saída do programa.
+
+inline int &falhasDosTestes()
+{
+    static int falhas = 0;
+    return falhas;
+}
+
+// Registra uma falha (e imprime a descrição) se a condição for falsa
+inline void verifica(bool condicao, const std::string &descricao)
+{
+    if (!condicao)
+    {
+        std::cerr << "FALHOU: " << descricao << std::endl;
+        falhasDosTestes()++;
+    }
+}
+
+// Imprime o resultado dos testes e retorna 0 se nenhuma verificação falhou
+inline int resultadoDosTestes()
+{
+    int falhas = falhasDosTestes();
+    std::cout << (falhas == 0 ? "OK" : "FALHAS: " + std::to_string(falhas)) << std::endl;
+    return falhas == 0 ? 0 : 1;
+}
+
+#endif // TESTE_H
@@ -0,0 +1,63 @@
+// Testes das arenas de batch e do lacre feito na entrega do batch
+// Compilar a partir desta pasta: g++ -std=c++20 TesteArena.cpp -o teste_arena -pthread
+#include <iostream>
+#include <string>
+#include <thread>
+#include "Dataframe.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    auto pPool = make_shared<ArenaPool>(2);
+
+    // A arena volta ao pool quando a última coluna que a usa é destruída
+    {
+        Column coluna("v", "int", pPool->acquire());
+        for (int i = 0; i < 10000; i++)
+            coluna.appendInt(i);
+        Column copia = coluna;
+        verifica(pPool->livres() == 0, "arena em uso não está livre");
+    }
+    verifica(pPool->livres() == 1, "arena devolvida depois da última coluna");
+
+    // Batch montado na arena e lacrado, como na entrega feita pelo extrator
+    {
+        shared_ptr<BatchArena> pArena = pPool->acquire();
+        Dataframe df;
+        df.adicionaColuna(Column("a", "int", pArena));
+        df.adicionaColuna(Column("b", "string", pArena));
+        for (int i = 0; i < 1000; i++)
+        {
+            df.columns[0].appendInt(i);
+            df.columns[1].appendString("x");
+        }
+        size_t iCapacidade = pArena->capacidade();
+        df.lacraArenas();
+
+        // Colunas diferentes do mesmo batch alteradas ao mesmo tempo: nenhuma aloca na arena
+        thread t1([&]
+                  { for (int i = 0; i < 100000; i++) df.columns[0].appendInt(i); });
+        thread t2([&]
+                  { for (int i = 0; i < 100000; i++) df.columns[1].appendString("yy"); });
+        t1.join();
+        t2.join();
+        verifica(pArena->capacidade() == iCapacidade, "arena lacrada não cresce");
+        verifica(df.columns[0].iGetSize() == 101000 && df.columns[0].getInt(999) == 999 &&
+                     df.columns[1].getString(0) == "x" && df.columns[1].getString(100999) == "yy",
+                 "valores preservados na cópia para o heap");
+
+        // clear em coluna lacrada não reaproveita os buffers da arena
+        Column lacrada("c", "int", pArena);
+        lacrada.appendInt(1);
+        lacrada.lacraArena();
+        lacrada.clear();
+        lacrada.appendInt(2);
+        verifica(lacrada.iGetSize() == 1 && lacrada.getInt(0) == 2 && pArena->capacidade() == iCapacidade,
+                 "clear de coluna lacrada");
+    }
+    verifica(pPool->livres() == 1, "arena reaproveitada volta ao pool");
+
+    return resultadoDosTestes();
+}
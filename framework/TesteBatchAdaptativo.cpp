@@ -0,0 +1,89 @@
+// Testes do ajuste automático do tamanho do batch do extrator
+// Compilar a partir desta pasta: g++ -std=c++20 TesteBatchAdaptativo.cpp -o teste_batch -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include <set>
+#include <mutex>
+#include "Manager.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Carregador que soma os ids e guarda os tamanhos de batch recebidos
+class Coletor : public Loader<Dataframe>
+{
+public:
+    using Loader::Loader;
+    mutex mtx;
+    int64_t iLinhas = 0, iSomaIds = 0;
+    set<int> setTamanhos;
+
+    void run(Dataframe df) override
+    {
+        lock_guard<mutex> lock(mtx);
+        iLinhas += df.getShape().first;
+        setTamanhos.insert(df.getShape().first);
+        for (int i = 0; i < df.getShape().first; i++)
+            iSomaIds += df.columns[0].getInt(i);
+    }
+};
+
+struct Resultado
+{
+    int64_t iLinhas, iSomaIds;
+    size_t iTamanhosDistintos;
+    int iBatchFinal;
+};
+
+Resultado extrai(const string &strCsv, bool bParalelo, double dLatenciaAlvoMs)
+{
+    Manager<Dataframe> manager(4);
+    Extrator<Dataframe> extrator(strCsv, "memo", 1000);
+    extrator.setParallelScan(bParalelo);
+    extrator.inferSchema();
+    extrator.setAdaptiveBatchSize(dLatenciaAlvoMs, 50, 20000);
+    manager.addExtractor(&extrator);
+    Coletor coletor(extrator.get_output_buffer());
+    manager.addLoader(&coletor);
+    manager.run();
+    return {coletor.iLinhas, coletor.iSomaIds, coletor.setTamanhos.size(), extrator.getBatchSize()};
+}
+
+int main()
+{
+    const int64_t iRegistros = 500000;
+    string strCsv = "id,cidade,valor\n";
+    for (int64_t i = 0; i < iRegistros; i++)
+        strCsv += to_string(i) + ",cidade" + to_string(i % 13) + "," + to_string(i % 100) + ".25\n";
+
+    for (bool bParalelo : {false, true})
+    {
+        string strModo = bParalelo ? "memo paralelo" : "memo sequencial";
+
+        // Latência alvo muito baixa: o batch encolhe, sem perder nem repetir linhas
+        Resultado pequeno = extrai(strCsv, bParalelo, 0.001);
+        verifica(pequeno.iLinhas == iRegistros && pequeno.iSomaIds == iRegistros * (iRegistros - 1) / 2,
+                 strModo + ": todas as linhas uma única vez");
+        verifica(pequeno.iBatchFinal >= 50 && pequeno.iBatchFinal <= 1000, strModo + ": batch dentro dos limites");
+
+        // Latência alvo alta: o batch cresce, limitado ao máximo
+        Resultado grande = extrai(strCsv, bParalelo, 1e5);
+        verifica(grande.iLinhas == iRegistros && grande.iSomaIds == iRegistros * (iRegistros - 1) / 2,
+                 strModo + ": todas as linhas com batches crescentes");
+        verifica(grande.iBatchFinal >= 1000 && grande.iBatchFinal <= 20000, strModo + ": batch dentro dos limites");
+
+        // Na leitura sequencial as tarefas são geradas à medida que as linhas são lidas, e o ajuste
+        // acontece durante a extração (na paralela, todas podem ser criadas antes da primeira medida)
+        if (!bParalelo)
+        {
+            verifica(pequeno.iTamanhosDistintos > 1 && pequeno.iBatchFinal < 1000, strModo + ": batch encolhe");
+            verifica(grande.iBatchFinal > 1000, strModo + ": batch cresce");
+        }
+
+        // Desativado: o tamanho inicial é mantido
+        Resultado fixo = extrai(strCsv, bParalelo, 0);
+        verifica(fixo.iLinhas == iRegistros && fixo.iBatchFinal == 1000, strModo + ": sem ajuste o batch não muda");
+    }
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,91 @@
+// Testes do buffer MPMC sem locks
+// Compilar a partir desta pasta: g++ -std=c++20 TesteBuffer.cpp -o teste_buffer -pthread
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include "Buffer.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    // Muitas voltas no anel em uma só thread: ordem FIFO e capacidade respeitada
+    {
+        Buffer<int> buffer(3);
+        bool emOrdem = true;
+        for (int i = 0; i < 1000; i++)
+        {
+            buffer.reserve_slot();
+            buffer.push(int(i));
+            if (i % 2 == 1)
+            {
+                emOrdem = emOrdem && buffer.pop(true) == i - 1;
+                emOrdem = emOrdem && buffer.pop(true) == i;
+            }
+        }
+        verifica(emOrdem, "ordem FIFO depois de várias voltas no anel");
+
+        for (int i = 0; i < 3; i++)
+            verifica(buffer.try_reserve_slot(), "reserva dentro da capacidade");
+        verifica(!buffer.try_reserve_slot() && !buffer.has_free_slot(), "buffer cheio recusa reserva");
+        for (int i = 0; i < 3; i++)
+            buffer.cancel_reservation();
+
+        verifica(!buffer.is_finished(), "buffer aberto não terminou");
+        buffer.close();
+        verifica(buffer.is_finished() && !buffer.pop().has_value(), "fechado e vazio termina");
+    }
+
+    // Tipos só movíveis passam pelo buffer sem cópia
+    {
+        Buffer<unique_ptr<int>> buffer(2);
+        buffer.reserve_slot();
+        buffer.push(make_unique<int>(7));
+        auto valor = buffer.pop(true);
+        verifica(valor && *valor && **valor == 7, "push e pop de valor só movível");
+    }
+
+    // Quatro produtores e quatro consumidores em um buffer pequeno: cada valor sai uma única vez
+    {
+        const int iProdutores = 4, iConsumidores = 4, iPorProdutor = 50000;
+        Buffer<int> buffer(5);
+        vector<atomic<int>> vezes(iProdutores * iPorProdutor);
+
+        vector<thread> consumidores;
+        for (int c = 0; c < iConsumidores; c++)
+        {
+            consumidores.emplace_back([&]
+                                      {
+                while (auto valor = buffer.pop())
+                    vezes[*valor]++; });
+        }
+        vector<thread> produtores;
+        for (int p = 0; p < iProdutores; p++)
+        {
+            produtores.emplace_back([&, p]
+                                    {
+                for (int i = 0; i < iPorProdutor; i++)
+                {
+                    buffer.reserve_slot();
+                    buffer.push(p * iPorProdutor + i);
+                } });
+        }
+        for (auto &produtor : produtores)
+            produtor.join();
+        buffer.close();
+        for (auto &consumidor : consumidores)
+            consumidor.join();
+
+        bool umaVez = true;
+        for (auto &contagem : vezes)
+            umaVez = umaVez && contagem.load() == 1;
+        verifica(umaVez, "cada valor retirado exatamente uma vez sob concorrência");
+        verifica(buffer.is_finished() && buffer.size() == 0, "buffer termina vazio");
+    }
+
+    return resultadoDosTestes();
+}
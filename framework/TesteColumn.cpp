@@ -0,0 +1,77 @@
+// Testes do armazenamento tipado das colunas
+// Compilar a partir desta pasta: g++ -std=c++20 TesteColumn.cpp -o teste_column -pthread
+#include <iostream>
+#include <string>
+#include "Dataframe.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    // Cada tipo volta com o mesmo valor que entrou
+    Column inteiros("i", "int");
+    inteiros.appendInt(-7);
+    inteiros.appendInt(INT64_MAX);
+    verifica(inteiros.getInt(0) == -7 && inteiros.getInt(1) == INT64_MAX, "int ida e volta");
+
+    Column reais("d", "double");
+    reais.appendDouble(0.1);
+    verifica(reais.getDouble(0) == 0.1, "double ida e volta");
+
+    Column booleanos("b", "bool");
+    booleanos.appendBool(true);
+    booleanos.appendBool(false);
+    verifica(booleanos.getBool(0) && !booleanos.getBool(1), "bool ida e volta");
+
+    Column textos("s");
+    textos.appendString("abc");
+    textos.appendString("");
+    textos.appendString("ção");
+    verifica(textos.getString(0) == "abc" && textos.getString(1).empty() && textos.getString(2) == "ção",
+             "string ida e volta (incluindo vazia)");
+
+    // Texto convertido direto para o tipo da coluna; campos inválidos não entram
+    Column lidos("i", "int");
+    verifica(lidos.bAdicionaTexto("42"), "texto int válido");
+    verifica(!lidos.bAdicionaTexto("4x"), "texto int inválido");
+    verifica(!lidos.bAdicionaTexto("1.5"), "texto real em coluna int");
+    verifica(lidos.iGetSize() == 1 && lidos.getInt(0) == 42, "só o campo válido é inserido");
+
+    Column lidosBool("b", "bool");
+    verifica(lidosBool.bAdicionaTexto("TRUE") && lidosBool.bAdicionaTexto("0") && !lidosBool.bAdicionaTexto("sim"),
+             "texto bool");
+    verifica(lidosBool.getBool(0) && !lidosBool.getBool(1), "valores bool lidos");
+
+    // Inferência de tipo
+    verifica(Column::strInfereTipo("12") == "int" && Column::strInfereTipo("1.5") == "double" &&
+                 Column::strInfereTipo("false") == "bool" && Column::strInfereTipo("1a") == "string",
+             "inferência de tipo");
+
+    // Conversão entre tipos e leitura como double
+    Column convertida = inteiros.convertTo("double");
+    verifica(convertida.isDouble() && convertida.getDouble(0) == -7.0, "conversão int -> double");
+    verifica(reais.getAsString(0) == "0.100000", "double formatado como em anyToString");
+
+    // Remoção, recorte e seleção de linhas mantêm os tipos
+    Column numeros("n", "int");
+    for (int i = 0; i < 5; i++)
+        numeros.appendInt(i * 10);
+    verifica(numeros.bRemovePeloIndex(1) && numeros.iGetSize() == 4 && numeros.getInt(1) == 20, "remoção por índice");
+    Column recorte = numeros.slice(1, 3);
+    verifica(recorte.isInt() && recorte.iGetSize() == 2 && recorte.getInt(0) == 20 && recorte.getInt(1) == 30, "slice");
+    Column selecionada = textos.gather({2, 0});
+    verifica(selecionada.getString(0) == "ção" && selecionada.getString(1) == "abc", "gather de strings");
+
+    // Linhas do DataFrame entram já tipadas
+    Dataframe df;
+    df.adicionaColuna(Column("id", "int"));
+    df.adicionaColuna(Column("nome", "string"));
+    df.adicionaColuna(Column("preco", "double"));
+    df.adicionaLinha({5, string("x"), 2.5});
+    verifica(df.getShape().first == 1 && df.columns[0].getInt(0) == 5 && df.columns[1].getString(0) == "x" &&
+                 df.columns[2].getDouble(0) == 2.5,
+             "linha do DataFrame");
+
+    return resultadoDosTestes();
+}
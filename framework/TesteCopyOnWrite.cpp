@@ -0,0 +1,74 @@
+// Testes do compartilhamento de buffers entre cópias de colunas (copy-on-write)
+// Compilar a partir desta pasta: g++ -std=c++20 TesteCopyOnWrite.cpp -o teste_cow -pthread
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Dataframe.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    Column original("v", "int");
+    for (int i = 0; i < 1000; i++)
+        original.appendInt(i);
+
+    // Cópias compartilham os buffers até a primeira alteração
+    Column copia = original;
+    verifica(copia.bCompartilhaDados(original), "cópia compartilha os buffers");
+    copia.appendInt(-1);
+    verifica(!copia.bCompartilhaDados(original), "alteração separa os buffers");
+    verifica(original.iGetSize() == 1000 && copia.iGetSize() == 1001 && copia.getInt(999) == 999,
+             "original intacto e cópia com o novo valor");
+
+    // Única dona altera no lugar, sem copiar
+    const int64_t *antes = copia.intData().data();
+    copia.bRemoveUltimoElemento();
+    verifica(copia.intData().data() == antes, "única dona altera os próprios buffers");
+
+    // clear de buffers compartilhados só solta a referência desta coluna
+    Column outra = original;
+    outra.clear();
+    verifica(outra.iGetSize() == 0 && original.iGetSize() == 1000, "clear não afeta a outra cópia");
+
+    // Empilhar numa coluna vazia passa a compartilhar, e a alteração seguinte copia
+    Column vazia("v", "int");
+    vazia.hStack(original);
+    verifica(vazia.bCompartilhaDados(original), "hStack em coluna vazia compartilha");
+    vazia.hStack(original);
+    verifica(vazia.iGetSize() == 2000 && original.iGetSize() == 1000, "hStack seguinte não altera a origem");
+
+    // Cópias de um mesmo DataFrame alteradas em paralelo (como nos ramos de um fan-out)
+    Dataframe df;
+    df.adicionaColuna(original);
+    const int iRamos = 8;
+    vector<Dataframe> ramos(iRamos, df);
+    vector<thread> threads;
+    for (int r = 0; r < iRamos; r++)
+    {
+        threads.emplace_back([&, r]
+                             {
+            for (int i = 0; i < 1000; i++)
+                ramos[r].columns[0].appendInt(r); });
+    }
+    // Enquanto isso, a original é lida e depois solta
+    int64_t soma = 0;
+    for (int64_t v : df.columns[0].intData())
+        soma += v;
+    df = Dataframe();
+    for (auto &t : threads)
+        t.join();
+
+    bool ramosCorretos = true;
+    for (int r = 0; r < iRamos; r++)
+    {
+        const Column &coluna = ramos[r].columns[0];
+        ramosCorretos = ramosCorretos && coluna.iGetSize() == 2000 && coluna.getInt(999) == 999 && coluna.getInt(1999) == r;
+    }
+    verifica(ramosCorretos, "ramos alterados em paralelo não interferem entre si");
+    verifica(soma == 999 * 1000 / 2 && original.getInt(999) == 999, "leitura concorrente da original");
+
+    return resultadoDosTestes();
+}
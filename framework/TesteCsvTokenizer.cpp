@@ -0,0 +1,54 @@
+// Testes dos casos de borda do CsvTokenizer
+// Compilar a partir desta pasta: g++ -std=c++20 TesteCsvTokenizer.cpp -o teste_csv
+#include <iostream>
+#include <string>
+#include <vector>
+#include "CsvTokenizer.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Separa o bloco e copia os campos de cada linha (as views só valem durante o callback)
+vector<vector<string>> separa(string_view bloco)
+{
+    CsvTokenizer tokenizer;
+    vector<vector<string>> linhas;
+    tokenizer.parse(bloco, [&](const vector<string_view> &campos)
+                    { linhas.emplace_back(campos.begin(), campos.end()); });
+    return linhas;
+}
+
+int main()
+{
+    auto linhas = separa("a,b,c\n1,,3\n");
+    verifica(linhas.size() == 2, "duas linhas");
+    verifica(linhas[1] == vector<string>{"1", "", "3"}, "campo vazio no meio");
+
+    linhas = separa("x,y\n\n\nz,w");
+    verifica(linhas.size() == 2 && linhas[1] == vector<string>{"z", "w"}, "linhas vazias e última linha sem '\\n'");
+
+    linhas = separa("a,b\r\nc,d\r\n");
+    verifica(linhas.size() == 2 && linhas[0][1] == "b" && linhas[1][1] == "d", "finais de linha \\r\\n");
+
+    linhas = separa("\"a,b\",c\n");
+    verifica(linhas.size() == 1 && linhas[0] == vector<string>{"a,b", "c"}, "vírgula entre aspas");
+
+    linhas = separa("\"linha 1\nlinha 2\",fim\nprox,1\n");
+    verifica(linhas.size() == 2 && linhas[0][0] == "linha 1\nlinha 2" && linhas[1][0] == "prox",
+             "quebra de linha entre aspas");
+
+    // Vários campos com aspas duplicadas na mesma linha: o buffer auxiliar cresce entre eles
+    string longo(200, 'x');
+    linhas = separa("\"a\"\"b\",\"" + longo + "\"\"\",\"\"\"c\"\r\n");
+    verifica(linhas.size() == 1 && linhas[0].size() == 3, "três campos escapados");
+    verifica(linhas[0][0] == "a\"b" && linhas[0][1] == longo + "\"" && linhas[0][2] == "\"c",
+             "conteúdo dos campos escapados");
+
+    linhas = separa("\"sem fim,1\n2");
+    verifica(linhas.size() == 1 && linhas[0][0] == "sem fim,1\n2", "aspas não fechadas vão até o fim do bloco");
+
+    verifica(CsvTokenizer::splitLinha("id,\"nome, completo\",preco") == vector<string>{"id", "nome, completo", "preco"},
+             "splitLinha do cabeçalho");
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,100 @@
+// Testes das estatísticas e do filtro declarados nos transformadores (addCounter/addSum/setFilter)
+// Compilar a partir desta pasta: g++ -std=c++20 TesteEstatisticas.cpp -o teste_estatisticas -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include <atomic>
+#include "Manager.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Filtro declarado: guarda quantas linhas chegaram selecionadas a `run`
+class FiltroVagos : public Transformer<Dataframe>
+{
+public:
+    atomic<int> iSelecionadas{0};
+    atomic<bool> bSemSelecao{false};
+
+    FiltroVagos()
+    {
+        Predicado vago = Predicado::igual("ocupado", 0);
+        addCounter("vagos", vago);
+        addCounter("reservados", !vago);
+        addSum("pessoas", "pessoas");
+        setFilter(vago);
+    }
+
+    Dataframe run(vector<Dataframe *> input) override
+    {
+        if (!input[0]->temSelecao())
+            bSemSelecao = true;
+        iSelecionadas += input[0]->iLinhasSelecionadas();
+        return std::move(*input[0]);
+    }
+};
+
+// Duas entradas com histórico: conta as linhas e não produz saída
+class ContaDuasEntradas : public Transformer<Dataframe>
+{
+public:
+    ContaDuasEntradas() { addCounter("linhas"); }
+    Dataframe run(vector<Dataframe *>) override { return Dataframe(); }
+};
+
+// Carregador que conta as linhas recebidas
+class Contador : public Loader<Dataframe>
+{
+public:
+    using Loader::Loader;
+    atomic<int> iLinhas{0};
+    void run(Dataframe df) override { iLinhas += df.getShape().first; }
+};
+
+// CSV com iLinhas linhas; a cada três, uma está vaga
+string csv(int iLinhas)
+{
+    string strCsv = "id,ocupado,pessoas\n";
+    for (int i = 0; i < iLinhas; i++)
+        strCsv += to_string(i) + "," + (i % 3 == 0 ? "0" : "1") + ",2\n";
+    return strCsv;
+}
+
+int main()
+{
+    // Filtro e estatísticas na mesma passada: as estatísticas veem o batch inteiro
+    {
+        Manager<Dataframe> manager(3);
+        Extrator<Dataframe> extrator(csv(3000), "memo", 70);
+        manager.addExtractor(&extrator);
+        FiltroVagos filtro;
+        filtro.addInputBuffer(&extrator.get_output_buffer());
+        manager.addTransformer(&filtro);
+        Contador contador(filtro.get_output_buffer());
+        manager.addLoader(&contador);
+        manager.run();
+
+        verifica(filtro.getCounter("vagos") == 1000 && filtro.getCounter("reservados") == 2000, "contadores declarados");
+        verifica(filtro.getSum("pessoas") == 6000.0, "soma declarada sobre todas as linhas");
+        verifica(!filtro.bSemSelecao && filtro.iSelecionadas == 1000, "entrada de run já filtrada");
+        verifica(contador.iLinhas == 1000, "só as linhas do filtro seguem para a saída");
+    }
+
+    // Com histórico, os batches da entrada 1 não contam de novo as linhas da entrada 0
+    {
+        Manager<Dataframe> manager(3);
+        Extrator<Dataframe> esquerda(csv(500), "memo", 50);
+        Extrator<Dataframe> direita(csv(800), "memo", 50);
+        manager.addExtractor(&esquerda);
+        manager.addExtractor(&direita);
+        ContaDuasEntradas conta;
+        conta.addInputBuffer(&esquerda.get_output_buffer());
+        conta.addInputBuffer(&direita.get_output_buffer());
+        manager.addTransformer(&conta);
+        Contador contador(conta.get_output_buffer());
+        manager.addLoader(&contador);
+        manager.run();
+        verifica(conta.getCounter("linhas") == 500, "estatísticas só dos batches da entrada 0");
+    }
+
+    return resultadoDosTestes();
+}
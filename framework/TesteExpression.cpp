@@ -0,0 +1,145 @@
+// Testes das expressões numéricas (Expr) e de withColumn
+// Compilar a partir desta pasta: g++ -std=c++20 TesteExpression.cpp -o teste_expression -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include "Manager.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Guarda as linhas recebidas num único DataFrame
+class Coletor : public Loader<Dataframe>
+{
+public:
+    using Loader::Loader;
+    mutex mtx;
+    Dataframe df;
+    void run(Dataframe batch) override
+    {
+        lock_guard<mutex> lock(mtx);
+        df.hStack(batch);
+    }
+};
+
+// Entradas das expressões do pipeline de hotéis: agregações das reservas e das pesquisas,
+// juntas pela cidade e pela data, como em pipe_hoteis.cpp (campos lidos sem schema)
+Dataframe entradasDoPipeline()
+{
+    string strReservas = "cidade_destino,data_ida_dia,data_ida_mes,quantidade_pessoas,preco\n";
+    string strPesquisas = "cidade_destino,data_ida_dia,data_ida_mes\n";
+    for (int i = 0; i < 600; i++)
+    {
+        string strChave = string(i % 2 ? "Rio" : "Recife") + "," + to_string(i % 3 + 1) + ",5";
+        strReservas += strChave + "," + to_string(i % 4 + 1) + "," + to_string(100 + i % 5) + ".5\n";
+        strPesquisas += strChave + "\n";
+    }
+
+    Manager<Dataframe> manager(3);
+    Extrator<Dataframe> reservas(strReservas, "memo", 50);
+    Extrator<Dataframe> pesquisas(strPesquisas, "memo", 50);
+    manager.addExtractor(&reservas);
+    manager.addExtractor(&pesquisas);
+    vector<string> chaves = {"cidade_destino", "data_ida_dia", "data_ida_mes"};
+    GroupByTransformer<Dataframe> agrupaReservas(&reservas.get_output_buffer(), chaves, {"quantidade_pessoas", "preco"},
+                                                 {"sum"}, "count_reservas");
+    GroupByTransformer<Dataframe> agrupaPesquisas(&pesquisas.get_output_buffer(), chaves, {}, {"count"}, "count_pesquisas");
+    manager.addTransformer(&agrupaReservas);
+    manager.addTransformer(&agrupaPesquisas);
+    HashJoinTransformer<Dataframe> junta(chaves);
+    junta.addInputBuffer(&agrupaReservas.get_output_buffer());
+    junta.addInputBuffer(&agrupaPesquisas.get_output_buffer());
+    manager.addTransformer(&junta);
+    Coletor coletor(junta.get_output_buffer());
+    manager.addLoader(&coletor);
+    manager.run();
+    return coletor.df;
+}
+
+// Tipo de uma coluna pelo nome ("" se não existir)
+string tipoDe(const Dataframe &df, const string &strNome)
+{
+    for (size_t j = 0; j < df.columns.size(); j++)
+    {
+        if (df.vstrColumnsName[j] == strNome)
+            return df.columns[j].strGetType();
+    }
+    return "";
+}
+
+int main()
+{
+    // Mais linhas que um bloco de avaliação, para cobrir a divisão em blocos
+    const int iLinhas = 2500;
+    Dataframe df;
+    df.adicionaColuna(Column("a", "int"));
+    df.adicionaColuna(Column("b", "double"));
+    df.adicionaColuna(Column("c", "string"));
+    for (int i = 0; i < iLinhas; i++)
+        df.adicionaLinha({int64_t(i), 0.5 * i, to_string(i % 10)});
+
+    // Operadores aritméticos e literais, com colunas int, double e string misturadas
+    df.withColumn("r", (col("a") + col("b")) * lit(2) - col("c") / 2.0);
+    const Column &r = df.columns.back();
+    bool bCorreto = r.isDouble() && r.iGetSize() == iLinhas;
+    for (int i = 0; bCorreto && i < iLinhas; i++)
+        bCorreto = r.getDouble(i) == (i + 0.5 * i) * 2 - (i % 10) / 2.0;
+    verifica(bCorreto, "soma, produto, subtração e divisão em todas as linhas");
+    verifica(df.vstrColumnsName.back() == "r", "coluna nova no fim");
+
+    // minimo/maximo e substituição de uma coluna existente
+    size_t iColunas = df.columns.size();
+    df.withColumn("r", minimo(col("a"), lit(100)) + maximo(col("b"), lit(1000)));
+    verifica(df.columns.size() == iColunas, "withColumn substitui a coluna de mesmo nome");
+    verifica(df.columns.back().getDouble(0) == 1000.0 && df.columns.back().getDouble(2400) == 100.0 + 1200.0,
+             "mínimo e máximo");
+
+    // Divisão por zero segue o IEEE 754; strings não numéricas viram 0
+    Dataframe zeros;
+    zeros.adicionaColuna(Column("x", "int"));
+    zeros.adicionaColuna(Column("s", "string"));
+    zeros.adicionaLinha({int64_t(1), string("abc")});
+    zeros.adicionaLinha({int64_t(0), string("0")});
+    zeros.withColumn("q", col("x") / col("s"));
+    verifica(isinf(zeros.columns.back().getDouble(0)) && isnan(zeros.columns.back().getDouble(1)),
+             "divisão por zero dá inf/nan");
+
+    // Coluna inexistente
+    bool bLancou = false;
+    try
+    {
+        df.withColumn("erro", col("nao_existe") + lit(1));
+    }
+    catch (const invalid_argument &)
+    {
+        bLancou = true;
+    }
+    verifica(bLancou, "coluna inexistente lança invalid_argument");
+
+    // As colunas usadas por PrecoMedio, TaxaOcupacaoHoteis e Faturamento chegam numéricas
+    Dataframe entradas = entradasDoPipeline();
+    verifica(entradas.getShape().first == 6, "um grupo por cidade e data");
+    verifica(tipoDe(entradas, "count_reservas") == "int" && tipoDe(entradas, "count_pesquisas") == "int",
+             "contagens como int");
+    verifica(tipoDe(entradas, "quantidade_pessoas_sum") == "double" && tipoDe(entradas, "preco_sum") == "double",
+             "somas como double");
+    entradas.withColumn("preco_medio", col("preco_sum") / col("count_reservas"))
+        .withColumn("taxa_ocupacao_hoteis", col("count_pesquisas") / col("quantidade_pessoas_sum"))
+        .withColumn("demanda", minimo(col("count_reservas"), col("quantidade_pessoas_sum")))
+        .withColumn("faturamento_esperado", col("preco_medio") * col("demanda"));
+    bool bFinitos = true;
+    for (int i = 0; i < entradas.getShape().first; i++)
+    {
+        for (string strColuna : {"preco_medio", "taxa_ocupacao_hoteis", "faturamento_esperado"})
+        {
+            int j = distance(entradas.vstrColumnsName.begin(),
+                             find(entradas.vstrColumnsName.begin(), entradas.vstrColumnsName.end(), strColuna));
+            bFinitos = bFinitos && isfinite(entradas.columns[j].getDouble(i)) && entradas.columns[j].getDouble(i) > 0;
+        }
+    }
+    verifica(bFinitos, "expressões do pipeline com valores positivos e finitos");
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,113 @@
+// Testes da agregação particionada do GroupByTransformer
+// Compilar a partir desta pasta: g++ -std=c++20 TesteGroupByTransformer.cpp -o teste_groupby_transformer -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include <set>
+#include <mutex>
+#include <cstdio>
+#include "Manager.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Guarda cada linha do resultado formatada, com os reais em precisão total
+class Coletor : public Loader<Dataframe>
+{
+public:
+    using Loader::Loader;
+    mutex mtx;
+    multiset<string> linhas;
+    int64_t iTotalContado = 0;
+
+    void run(Dataframe df) override
+    {
+        lock_guard<mutex> lock(mtx);
+        for (int i = 0; i < df.getShape().first; i++)
+        {
+            string strLinha;
+            for (const Column &coluna : df.columns)
+            {
+                char buf[64];
+                if (coluna.isDouble())
+                    snprintf(buf, sizeof(buf), "%.10g", coluna.getDouble(i));
+                else
+                    snprintf(buf, sizeof(buf), "%s", coluna.getAsString(i).c_str());
+                strLinha += string(buf) + ";";
+            }
+            linhas.insert(strLinha);
+        }
+        for (int i = 0; i < df.getShape().first; i++)
+            iTotalContado += static_cast<int64_t>(df.columns.back().getAsDouble(i));
+    }
+};
+
+struct Resultado
+{
+    multiset<string> linhas;
+    int64_t iTotalContado;
+};
+
+// Roda o agrupamento sobre o CSV e devolve as linhas do resultado
+Resultado agrupa(const string &strCsv, bool bParticionado, bool bTipado)
+{
+    Manager<Dataframe> manager(4);
+    Extrator<Dataframe> extrator(strCsv, "memo", 37);
+    extrator.setParallelScan(true);
+    if (bTipado)
+        extrator.inferSchema(); // "taxa" vira double e "quartos" vira int
+    manager.addExtractor(&extrator);
+    GroupByTransformer<Dataframe> agrupador(&extrator.get_output_buffer(), {"cidade", "taxa"}, {"quartos", "preco"},
+                                            {"sum"}, "resultado");
+    agrupador.setPartitionedAggregation(bParticionado);
+    manager.addTransformer(&agrupador);
+    Coletor coletor(agrupador.get_output_buffer());
+    manager.addLoader(&coletor);
+    manager.run();
+    return {coletor.linhas, coletor.iTotalContado};
+}
+
+int main()
+{
+    // Taxas que só diferem depois da 6ª casa decimal
+    const char *cidades[] = {"Rio", "Recife", "Manaus"};
+    const char *taxas[] = {"0.1000001", "0.1000002", "0.25"};
+    string strCsv = "cidade,taxa,quartos,preco\n";
+    const int iLinhas = 5000;
+    for (int i = 0; i < iLinhas; i++)
+    {
+        strCsv += string(cidades[i % 3]) + "," + taxas[(i / 3) % 3] + "," + to_string(i % 11) + "," +
+                  to_string(i % 7) + ".5\n";
+    }
+
+    // Chaves lidas como texto
+    Resultado particionado = agrupa(strCsv, true, false);
+    verifica(particionado.linhas.size() == 9, "chaves em texto: um grupo por cidade e taxa");
+    verifica(particionado.iTotalContado == iLinhas, "chaves em texto: contagens somam todas as linhas");
+
+    // Chaves tipadas: taxas que só diferem depois da 6ª casa decimal formam grupos distintos
+    Resultado particionadoTipado = agrupa(strCsv, true, true);
+    verifica(particionadoTipado.linhas.size() == 9, "chaves tipadas: taxas próximas não se juntam");
+    verifica(particionadoTipado.iTotalContado == iLinhas, "chaves tipadas: contagens somam todas as linhas");
+
+    // O modo padrão dá o mesmo resultado que o particionado
+    verifica(agrupa(strCsv, false, false).linhas == particionado.linhas, "chaves em texto: mesmo resultado nos dois modos");
+    verifica(agrupa(strCsv, false, true).linhas == particionadoTipado.linhas, "chaves tipadas: mesmo resultado nos dois modos");
+
+    // Junção de resultados parciais: somas int que não cabem em int nem em double sem perda
+    Dataframe parcial, outro;
+    for (Dataframe *df : {&parcial, &outro})
+    {
+        df->adicionaColuna(Column("cidade", "string"));
+        df->adicionaColuna(Column("quartos_sum", "int"));
+        df->adicionaColuna(Column("count", "int"));
+        df->columns[0].appendString("Rio");
+        df->columns[1].appendInt((int64_t(1) << 53) + 1);
+        df->columns[2].appendInt(3000000000LL);
+    }
+    parcial.hStackGroup(outro);
+    verifica(parcial.getShape().first == 1 && parcial.columns[1].getInt(0) == (int64_t(1) << 54) + 2 &&
+                 parcial.columns[2].getInt(0) == 6000000000LL,
+             "somas int acumuladas em int64_t");
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,74 @@
+// Testes do kernel tipado de agrupamento (dfGroupby e dfAgrega)
+// Compilar a partir desta pasta: g++ -std=c++20 TesteGroupby.cpp -o teste_groupby -pthread
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include "Dataframe.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Coluna do resultado pelo nome
+const Column &coluna(const Dataframe &df, const string &strNome)
+{
+    auto it = find(df.vstrColumnsName.begin(), df.vstrColumnsName.end(), strNome);
+    if (it == df.vstrColumnsName.end())
+        throw invalid_argument("Coluna '" + strNome + "' não encontrada.");
+    return df.columns[it - df.vstrColumnsName.begin()];
+}
+
+int main()
+{
+    Dataframe df;
+    df.adicionaColuna(Column("cidade", "string"));
+    df.adicionaColuna(Column("taxa", "double"));
+    df.adicionaColuna(Column("quartos", "int"));
+    df.adicionaColuna(Column("preco", "string"));
+    const int64_t iGrande = (int64_t(1) << 53) + 1;
+    df.adicionaLinha({string("Rio"), 0.1, iGrande, string("10.5")});
+    df.adicionaLinha({string("Recife"), 0.1, int64_t(3), string("4")});
+    df.adicionaLinha({string("Rio"), 0.1, iGrande, string("x")});
+    df.adicionaLinha({string("Rio"), 0.2, int64_t(5), string("1.5")});
+
+    // Uma chave: grupos na ordem em que aparecem, somas inteiras sem perda de precisão
+    Dataframe porCidade = df.dfGroupby({"cidade"}, {"quartos", "preco"});
+    verifica(porCidade.getShape().first == 2, "dois grupos");
+    verifica(coluna(porCidade, "cidade").getString(0) == "Rio" && coluna(porCidade, "cidade").getString(1) == "Recife",
+             "grupos na ordem da primeira ocorrência");
+    const Column &somaQuartos = coluna(porCidade, "quartos_sum");
+    verifica(somaQuartos.isInt() && somaQuartos.getInt(0) == 2 * iGrande + 5, "soma de int continua int e exata");
+    verifica(coluna(porCidade, "preco_sum").getDouble(0) == 12.0, "strings inválidas somam zero");
+    verifica(coluna(porCidade, "preco_mean").getDouble(0) == 4.0, "média conta as linhas inválidas");
+    verifica(coluna(porCidade, "count").getInt(0) == 3 && coluna(porCidade, "count").getInt(1) == 1, "contagem");
+
+    // Duas chaves, uma delas double
+    Dataframe porTaxa = df.dfGroupby({"cidade", "taxa"}, {"quartos"}, true, false, true);
+    verifica(porTaxa.getShape().first == 3, "chaves compostas com double");
+    verifica(porTaxa.vstrColumnsName == vector<string>{"cidade", "taxa", "quartos_sum", "count"}, "layout só com soma e contagem");
+    verifica(coluna(porTaxa, "taxa").isDouble(), "chave double mantém o tipo");
+
+    // Chave codificada por dicionário agrupa igual à chave em texto
+    auto pDicionario = make_shared<StringInterner>();
+    Dataframe codificado;
+    codificado.vstrColumnsName = {"cidade", "quartos"};
+    codificado.columns.push_back(Column::dicionario("cidade", pDicionario));
+    codificado.columns.push_back(Column("quartos", "int"));
+    for (string strCidade : {"Rio", "Recife", "Rio"})
+    {
+        codificado.columns[0].appendCode(pDicionario->codigo(strCidade));
+        codificado.columns[1].appendInt(1);
+    }
+    Dataframe porCodigo = codificado.dfGroupby({"cidade"}, {"quartos"});
+    verifica(porCodigo.getShape().first == 2 && coluna(porCodigo, "cidade").getString(0) == "Rio" &&
+                 coluna(porCodigo, "quartos_sum").getInt(0) == 2,
+             "agrupamento por dicionário");
+
+    // dfAgrega com mínimo, máximo e variância
+    Dataframe estatisticas = df.dfAgrega({"cidade"}, {{"quartos", "min"}, {"quartos", "max"}, {"taxa", "var"}, {"", "count"}});
+    verifica(coluna(estatisticas, "quartos_min").getInt(0) == 5 && coluna(estatisticas, "quartos_max").getInt(0) == iGrande,
+             "mínimo e máximo inteiros");
+    double dVariancia = coluna(estatisticas, "taxa_var").getDouble(0);
+    verifica(dVariancia > 0.00333 && dVariancia < 0.00334, "variância amostral");
+
+    return resultadoDosTestes();
+}
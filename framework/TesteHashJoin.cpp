@@ -0,0 +1,126 @@
+// Testes da junção incremental por hash
+// Compilar a partir desta pasta: g++ -std=c++20 TesteHashJoin.cpp -o teste_join -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include <set>
+#include "Transformer.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Batch com uma chave e um valor
+Dataframe batch(const string &strValor, const string &strTipoChave, const vector<pair<string, int>> &linhas)
+{
+    Dataframe df;
+    df.adicionaColuna(Column("k", strTipoChave));
+    df.adicionaColuna(Column(strValor, "int"));
+    for (const auto &[chave, valor] : linhas)
+    {
+        if (strTipoChave == "int")
+            df.columns[0].appendInt(stoll(chave));
+        else
+            df.columns[0].appendString(chave);
+        df.columns[1].appendInt(valor);
+    }
+    return df;
+}
+
+// Linhas do resultado no formato "k|esquerda|direita"
+void coleta(const Dataframe &df, multiset<string> &saida)
+{
+    for (int i = 0; i < df.getShape().first; i++)
+        saida.insert(df.columns[0].getAsString(i) + "|" + df.columns[1].getAsString(i) + "|" + df.columns[2].getAsString(i));
+}
+
+int main()
+{
+    // Lados chegando intercalados, com chaves repetidas: cada par aparece uma única vez
+    {
+        HashJoinTransformer<Dataframe> join({"k"});
+        vector<Dataframe> esquerda = {batch("l", "int", {{"1", 10}, {"2", 20}}), batch("l", "int", {{"1", 11}, {"3", 30}})};
+        vector<Dataframe> direita = {batch("r", "int", {{"1", 100}}), batch("r", "int", {{"3", 300}, {"1", 101}, {"4", 400}})};
+
+        multiset<string> resultado;
+        coleta(join.run({&esquerda[0], nullptr}), resultado);
+        coleta(join.run({nullptr, &direita[0]}), resultado);
+        coleta(join.run({&esquerda[1], nullptr}), resultado);
+        Dataframe ultimo = join.run({nullptr, &direita[1]});
+        coleta(ultimo, resultado);
+
+        multiset<string> esperado = {"1|10|100", "1|11|100", "1|10|101", "1|11|101", "3|30|300"};
+        verifica(resultado == esperado, "pares da junção, cada um uma vez");
+        verifica(ultimo.vstrColumnsName == vector<string>{"k", "l", "r"}, "layout: lado 0 inteiro e não-chaves do lado 1");
+    }
+
+    // Chave int de um lado e string do outro
+    {
+        HashJoinTransformer<Dataframe> join({"k"});
+        Dataframe esquerda = batch("l", "int", {{"5", 1}, {"6", 2}});
+        Dataframe direita = batch("r", "string", {{"5", 3}, {"7", 4}});
+        multiset<string> resultado;
+        coleta(join.run({&esquerda, nullptr}), resultado);
+        coleta(join.run({nullptr, &direita}), resultado);
+        verifica(resultado == multiset<string>{"5|1|3"}, "chaves de tipos diferentes");
+    }
+
+    // Chave codificada por dicionário de um lado e texto comum do outro
+    {
+        HashJoinTransformer<Dataframe> join({"k"});
+        auto pDicionario = make_shared<StringInterner>();
+        Dataframe esquerda;
+        esquerda.vstrColumnsName = {"k", "l"};
+        esquerda.columns.push_back(Column::dicionario("k", pDicionario));
+        esquerda.columns.push_back(Column("l", "int"));
+        for (string strCidade : {"Rio", "Recife"})
+        {
+            esquerda.columns[0].appendCode(pDicionario->codigo(strCidade));
+            esquerda.columns[1].appendInt(static_cast<int>(strCidade.size()));
+        }
+        Dataframe direita = batch("r", "string", {{"Recife", 9}});
+        multiset<string> resultado;
+        coleta(join.run({nullptr, &direita}), resultado);
+        coleta(join.run({&esquerda, nullptr}), resultado);
+        verifica(resultado == multiset<string>{"Recife|6|9"}, "dicionário contra texto comum");
+    }
+
+    // Chave que muda de tipo entre batches do mesmo lado: as linhas guardadas continuam achadas
+    {
+        HashJoinTransformer<Dataframe> join({"k"});
+        vector<Dataframe> esquerda = {batch("l", "int", {{"1", 10}}), batch("l", "string", {{"2", 20}})};
+        vector<Dataframe> direita = {batch("r", "int", {{"1", 100}}), batch("r", "int", {{"2", 200}, {"1", 101}})};
+        multiset<string> resultado;
+        coleta(join.run({&esquerda[0], nullptr}), resultado);
+        coleta(join.run({nullptr, &direita[0]}), resultado);
+        coleta(join.run({&esquerda[1], nullptr}), resultado);
+        coleta(join.run({nullptr, &direita[1]}), resultado);
+        verifica(resultado == multiset<string>{"1|10|100", "2|20|200", "1|10|101"}, "chave de tipo variável no mesmo lado");
+    }
+
+    // Batches com as colunas em outra ordem, com tipos diferentes ou faltando colunas
+    {
+        HashJoinTransformer<Dataframe> join({"k"});
+        Dataframe inteiro = batch("l", "int", {{"1", 10}});
+        Dataframe real;
+        real.adicionaColuna(Column("l", "double"));
+        real.adicionaColuna(Column("k", "int"));
+        real.columns[0].appendDouble(2.5);
+        real.columns[1].appendInt(1);
+        Dataframe semValor;
+        semValor.adicionaColuna(Column("k", "int"));
+        semValor.columns[0].appendInt(1);
+        Dataframe direita = batch("r", "int", {{"1", 100}});
+
+        multiset<string> resultado;
+        coleta(join.run({&inteiro, nullptr}), resultado);
+        coleta(join.run({&real, nullptr}), resultado);
+        Dataframe descartado = join.run({&semValor, nullptr});
+        Dataframe ultimo = join.run({nullptr, &direita});
+        coleta(ultimo, resultado);
+        verifica(descartado.columns.empty(), "batch sem uma das colunas do lado é descartado");
+        verifica(resultado == multiset<string>{"1|10.000000|100", "1|2.500000|100"}, "colunas reordenadas e int com double");
+        verifica(ultimo.vstrColumnsName == vector<string>{"k", "l", "r"} && ultimo.columns[1].isDouble(),
+                 "layout do primeiro batch e tipo comum");
+    }
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,127 @@
+// Testes da leitura de arquivos CSV mapeados em memória e da divisão deles em blocos
+// Compilar a partir desta pasta: g++ -std=c++20 TesteMappedFile.cpp -o teste_mmap -lsqlite3 -pthread
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include "Manager.h"
+#include "Teste.h"
+
+using namespace std;
+
+atomic<long> linhas{0}, somaIds{0};
+
+class Contador : public Loader<Dataframe>
+{
+public:
+    using Loader::Loader;
+    void run(Dataframe df) override
+    {
+        linhas += df.getShape().first;
+        for (int i = 0; i < df.getShape().first; i++)
+            somaIds += df.columns[0].getAsDouble(i);
+    }
+};
+
+// Extrai o arquivo (ou o conteúdo, no modo "memo") e confere as linhas e a soma dos ids
+void confere(const string &strEntrada, const string &strModo, int iBatch, bool bParalelo, long iEsperadas, long iSomaEsperada)
+{
+    linhas = 0;
+    somaIds = 0;
+    {
+        Manager<Dataframe> manager(4);
+        Extrator<Dataframe> extrator(strEntrada, strModo, iBatch);
+        extrator.setParallelScan(bParalelo);
+        manager.addExtractor(&extrator);
+        Contador contador(extrator.get_output_buffer());
+        manager.addLoader(&contador);
+        manager.run();
+    }
+    string strCaso = strModo + (bParalelo ? " paralelo" : "") + " com batch " + to_string(iBatch);
+    verifica(linhas == iEsperadas, strCaso + ": todas as linhas");
+    verifica(somaIds == iSomaEsperada, strCaso + ": nenhum registro partido ou repetido");
+}
+
+// Grava o conteúdo no arquivo
+void grava(const string &strCaminho, const string &strConteudo)
+{
+    ofstream arquivo(strCaminho);
+    arquivo << strConteudo;
+}
+
+int main()
+{
+    string strCaminho = "teste_mmap.csv";
+    const int iRegistros = 2000;
+    long somaEsperada = 0;
+    string strConteudo = "id,texto\n";
+    for (int i = 0; i < iRegistros; i++)
+    {
+        strConteudo += to_string(i) + ",linha " + to_string(i % 17) + "\n";
+        somaEsperada += i;
+    }
+    grava(strCaminho, strConteudo);
+
+    // Mapeamento do arquivo inteiro
+    {
+        MappedFile arquivo(strCaminho);
+        verifica(arquivo.isOpen() && arquivo.view() == strConteudo, "conteúdo mapeado igual ao arquivo");
+        MappedFile movido(std::move(arquivo));
+        verifica(!arquivo.isOpen() && movido.view() == strConteudo, "mapeamento transferido ao mover");
+    }
+    {
+        grava("teste_mmap_vazio.csv", "");
+        MappedFile vazio("teste_mmap_vazio.csv");
+        verifica(!vazio.isOpen() && vazio.view().empty(), "arquivo vazio não é mapeado");
+        remove("teste_mmap_vazio.csv");
+    }
+    bool bLancou = false;
+    try
+    {
+        MappedFile inexistente("nao_existe.csv");
+    }
+    catch (const runtime_error &)
+    {
+        bLancou = true;
+    }
+    verifica(bLancou, "arquivo inexistente lança runtime_error");
+
+    // Fronteiras calculadas no texto
+    verifica(MappedFile::fronteiraDeLinha("l1\nl2\nl3\n", 1) == 3 && MappedFile::fronteiraDeLinha("l1\nl2\nl3\n", 4) == 6,
+             "fronteira de linha");
+    string_view texto = "a,\"x\ny\",1\nb,z,2\n";
+    verifica(MappedFile::fronteiraDeLinha(texto, 3) == 5, "fronteira de linha ignora as aspas");
+    verifica(MappedFile::fronteiraDeRegistro(texto, 0, 3) == 10, "fronteira de registro pula a quebra entre aspas");
+    verifica(MappedFile::fronteiraDeRegistro(texto, 0, 11) == texto.size(), "fronteira de registro no último registro");
+    verifica(MappedFile::temQuebraEntreAspas(texto), "detecta quebra entre aspas");
+    verifica(!MappedFile::temQuebraEntreAspas("a,\"x,y\"\nb,c\n"), "aspas sem quebra de linha");
+    verifica(MappedFile::blocoEntre("l1\nl2\nl3\n", 1, 4) == "l2\n", "bloco com as linhas que começam no intervalo");
+
+    // Arquivo lido em blocos de vários tamanhos
+    for (int iBatch : {1, 7, 500, 5000})
+    {
+        confere(strCaminho, "mmap", iBatch, false, iRegistros, somaEsperada);
+        confere(strCaminho, "mmap", iBatch, true, iRegistros, somaEsperada);
+        confere(strConteudo, "memo", iBatch, true, iRegistros, somaEsperada);
+    }
+
+    // Registros que atravessam linhas, com aspas escapadas
+    string strAspas = "id,texto\n";
+    for (int i = 0; i < iRegistros; i++)
+    {
+        strAspas += to_string(i) + ",";
+        strAspas += i % 3 == 0 ? "\"linha 1\nlinha 2, \"\"com aspas\"\"\"\n" : "simples\n";
+    }
+    grava(strCaminho, strAspas);
+    for (int iBatch : {1, 7, 500})
+    {
+        confere(strCaminho, "mmap", iBatch, false, iRegistros, somaEsperada);
+        confere(strCaminho, "mmap", iBatch, true, iRegistros, somaEsperada);
+        confere(strAspas, "memo", iBatch, true, iRegistros, somaEsperada);
+    }
+    remove(strCaminho.c_str());
+
+    return resultadoDosTestes();
+}
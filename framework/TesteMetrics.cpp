@@ -0,0 +1,71 @@
+// Testes do registro de métricas por shard (Metrics)
+// Compilar a partir desta pasta: g++ -std=c++20 TesteMetrics.cpp -o teste_metrics -pthread
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include "Metrics.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    const int iThreads = 4, iPorThread = 100000;
+    TaskQueue fila(iThreads);
+    Metrics metricas;
+    int contador = metricas.addCounter("linhas");
+    int soma = metricas.addSum("valores");
+    int histograma = metricas.addHistogram("tamanhos", {10, 100, 1});
+    metricas.attach(&fila);
+
+    // Threads da pool (cada uma no seu shard) e threads de fora (no shard compartilhado) ao mesmo tempo
+    vector<thread> threads;
+    for (int t = 0; t < 2 * iThreads; t++)
+    {
+        threads.emplace_back([&, t]
+                             {
+            if (t < iThreads)
+                fila.registerWorker(t);
+            for (int i = 0; i < iPorThread; i++)
+            {
+                metricas.increment(contador);
+                metricas.accumulate(soma, 0.5);
+            } });
+    }
+    for (auto &t : threads)
+        t.join();
+    verifica(metricas.counter("linhas") == int64_t(2) * iThreads * iPorThread, "contador soma todos os shards");
+    verifica(metricas.sum("valores") == 0.5 * 2 * iThreads * iPorThread, "soma de todos os shards");
+
+    // Faixas do histograma (limites ordenados no registro): (-inf,1], (1,10], (10,100], (100,inf)
+    for (double valor : {0.0, 1.0, 1.5, 10.0, 50.0, 100.0, 101.0, 1e9})
+        metricas.observe(histograma, valor);
+    metricas.observe(histograma, 5.0, 3);
+    verifica(metricas.histogram("tamanhos") == vector<int64_t>{2, 5, 2, 2}, "faixas do histograma");
+    verifica(metricas.value(histograma) == 11.0, "total de observações do histograma");
+
+    // Consultas por nome e tipo
+    verifica(metricas.find("valores") == soma && metricas.find("outra") == -1 && metricas.size() == 3, "busca por nome");
+    bool bLancou = false;
+    try
+    {
+        metricas.counter("valores");
+    }
+    catch (const invalid_argument &)
+    {
+        bLancou = true;
+    }
+    verifica(bLancou, "leitura com o tipo errado lança invalid_argument");
+
+    // attach zera os valores e mantém as definições
+    metricas.attach(&fila);
+    verifica(metricas.counter("linhas") == 0 && metricas.sum("valores") == 0.0 &&
+                 metricas.histogram("tamanhos") == vector<int64_t>(4, 0),
+             "attach zera as métricas");
+    metricas.increment(contador, 7);
+    verifica(metricas.value(contador) == 7.0, "métricas continuam utilizáveis depois do attach");
+
+    return resultadoDosTestes();
+}
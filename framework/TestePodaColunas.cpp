@@ -0,0 +1,81 @@
+// Testes da poda de colunas feita pelo Manager a partir das colunas declaradas pelas etapas
+// Compilar a partir desta pasta: g++ -std=c++20 TestePodaColunas.cpp -o teste_poda -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mutex>
+#include "Manager.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Filtro que só repassa os batches, guardando as colunas que recebeu
+class Repassa : public Transformer<Dataframe>
+{
+public:
+    using Transformer::Transformer;
+    mutex mtx;
+    vector<string> vstrRecebidas;
+
+    Dataframe run(vector<Dataframe *> input) override
+    {
+        lock_guard<mutex> lock(mtx);
+        vstrRecebidas = input[0]->vstrColumnsName;
+        return std::move(*input[0]);
+    }
+};
+
+// Carregador que guarda as colunas e o número de linhas que chegaram
+class Coletor : public Loader<Dataframe>
+{
+public:
+    using Loader::Loader;
+    mutex mtx;
+    vector<string> vstrRecebidas;
+    int iLinhas = 0;
+
+    void run(Dataframe df) override
+    {
+        lock_guard<mutex> lock(mtx);
+        vstrRecebidas = df.vstrColumnsName;
+        iLinhas += df.getShape().first;
+    }
+};
+
+int main()
+{
+    // Reservas com colunas que nenhuma etapa lê
+    string strCsv = "id,cidade_destino,hotel,data_ida_dia,data_ida_mes,ocupado,quantidade_pessoas,preco,obs\n";
+    for (int i = 0; i < 300; i++)
+    {
+        strCsv += to_string(i) + "," + (i % 2 ? "Rio" : "Recife") + ",h" + to_string(i % 5) + "," + to_string(i % 28 + 1) +
+                  "," + to_string(i % 12 + 1) + "," + to_string(i % 2) + ",2,100.5,nada\n";
+    }
+
+    // Extrator -> filtro (declara o que lê e repassa as colunas) -> agrupador -> carregador
+    Manager<Dataframe> manager(2);
+    Extrator<Dataframe> extrator(strCsv, "memo", 50);
+    manager.addExtractor(&extrator);
+
+    Repassa filtro;
+    filtro.addInputBuffer(&extrator.get_output_buffer());
+    filtro.declareColumns({"ocupado", "cidade_destino"});
+    manager.addTransformer(&filtro);
+
+    GroupByTransformer<Dataframe> agrupador(&filtro.get_output_buffer(), {"cidade_destino", "data_ida_dia", "data_ida_mes"},
+                                            {"quantidade_pessoas", "preco"}, {"sum"}, "count_reservas");
+    manager.addTransformer(&agrupador);
+
+    Coletor coletor(agrupador.get_output_buffer());
+    manager.addLoader(&coletor);
+    manager.run();
+
+    // O extrator lê exatamente as seis colunas usadas pelo filtro e pelo agrupador, na ordem do cabeçalho
+    vector<string> vstrEsperadas = {"cidade_destino", "data_ida_dia", "data_ida_mes", "ocupado", "quantidade_pessoas", "preco"};
+    verifica(extrator.hasProjection(), "extrator projetado pelo Manager");
+    verifica(extrator.getProjection() == vstrEsperadas, "projeção com as seis colunas necessárias");
+    verifica(filtro.vstrRecebidas == vstrEsperadas, "filtro recebe só as colunas podadas");
+    verifica(coletor.iLinhas > 0 && coletor.vstrRecebidas.size() == 6, "agrupamento sobre as colunas podadas");
+
+    return resultadoDosTestes();
+}
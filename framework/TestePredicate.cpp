@@ -0,0 +1,100 @@
+// Testes dos predicados avaliados em bitmap (Predicado e Selecao)
+// Compilar a partir desta pasta: g++ -std=c++20 TestePredicate.cpp -o teste_predicate -pthread
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Dataframe.h"
+#include "Predicate.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    // 130 linhas: duas palavras completas do bitmap e uma parcial
+    const size_t iLinhas = 130;
+    Dataframe df;
+    df.adicionaColuna(Column("n", "int"));
+    df.adicionaColuna(Column("x", "double"));
+    df.adicionaColuna(Column("s", "string"));
+    df.adicionaColuna(Column("b", "bool"));
+    for (size_t i = 0; i < iLinhas; i++)
+        df.adicionaLinha({int64_t(i % 10), 0.5 * i, string(i % 3 == 0 ? "a" : "b"), i % 2 == 0});
+    const auto &nomes = df.vstrColumnsName;
+    const auto &colunas = df.columns;
+
+    // Folhas
+    Selecao igual = Predicado::igual("n", 3).avaliar(nomes, colunas);
+    verifica(igual.contagem() == 13 && igual.bSelecionada(3) && igual.bSelecionada(123) && !igual.bSelecionada(4),
+             "igual em coluna int");
+    verifica(Predicado::igual("s", string("a")).avaliar(nomes, colunas).contagem() == 44, "igual em coluna string");
+    verifica(Predicado::igual("b", true).avaliar(nomes, colunas).contagem() == 65, "igual em coluna bool");
+    verifica(Predicado::entre("x", 10.0, 20.0).avaliar(nomes, colunas).indices() ==
+                 vector<size_t>{20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40},
+             "entre inclusivo");
+    verifica(Predicado::em("n", {1, 2, 99}).avaliar(nomes, colunas).contagem() == 26, "lista IN (valor ausente ignorado)");
+    verifica(Predicado::em("s", {string("c"), string("d")}).avaliar(nomes, colunas).contagem() == 0, "lista IN sem nenhum valor presente");
+    verifica(Predicado::igual("n", 2.5).avaliar(nomes, colunas).contagem() == 0 &&
+                 Predicado::igual("n", string("2.5")).avaliar(nomes, colunas).contagem() == 0,
+             "valor fracionário não é truncado numa coluna int");
+    verifica(Predicado::em("n", {2.0, 3.5, string("4")}).avaliar(nomes, colunas).contagem() == 26,
+             "lista IN numa coluna int aceita só valores inteiros exatos");
+
+    // Combinações
+    Predicado tres = Predicado::igual("n", 3);
+    Predicado a = Predicado::igual("s", string("a"));
+    Selecao e = (tres && a).avaliar(nomes, colunas);
+    Selecao ou = (tres || a).avaliar(nomes, colunas);
+    bool bCorreto = true;
+    for (size_t i = 0; i < iLinhas; i++)
+    {
+        bool bTres = i % 10 == 3, bA = i % 3 == 0;
+        bCorreto = bCorreto && e.bSelecionada(i) == (bTres && bA) && ou.bSelecionada(i) == (bTres || bA);
+    }
+    verifica(bCorreto, "E e OU linha a linha");
+
+    // NÃO não marca as linhas além do fim do batch (bits de sobra da última palavra)
+    Selecao nao = (!tres).avaliar(nomes, colunas);
+    verifica(nao.contagem() == iLinhas - 13, "NÃO conta só as linhas do batch");
+    verifica(nao.indices().back() == iLinhas - 1, "última linha selecionada dentro do batch");
+    Selecao todas(iLinhas, true);
+    todas.inverte();
+    verifica(Selecao(iLinhas, true).contagem() == iLinhas && todas.contagem() == 0, "seleção cheia e invertida");
+
+    // Coluna codificada por dicionário compara códigos
+    auto pDicionario = make_shared<StringInterner>();
+    Dataframe codificado;
+    codificado.vstrColumnsName = {"cidade"};
+    codificado.columns.push_back(Column::dicionario("cidade", pDicionario));
+    for (string strCidade : {"Rio", "Recife", "Rio", "Manaus"})
+        codificado.columns[0].appendCode(pDicionario->codigo(strCidade));
+    verifica(Predicado::igual("cidade", string("Rio")).avaliar(codificado.vstrColumnsName, codificado.columns).indices() ==
+                 vector<size_t>{0, 2},
+             "igual por código do dicionário");
+    verifica(Predicado::em("cidade", {string("Manaus"), string("Recife"), string("Natal")})
+                     .avaliar(codificado.vstrColumnsName, codificado.columns)
+                     .indices() == vector<size_t>{1, 3},
+             "IN por códigos do dicionário");
+    verifica(Predicado::igual("cidade", string("Natal")).avaliar(codificado.vstrColumnsName, codificado.columns).contagem() == 0,
+             "valor fora do dicionário");
+
+    // Avaliação conjunta: a subexpressão compartilhada dá o mesmo resultado em cada predicado
+    vector<Selecao> juntos = Predicado::avaliarJuntos({tres, !tres, tres && a}, nomes, colunas);
+    verifica(juntos.size() == 3 && juntos[0].indices() == igual.indices() && juntos[1].indices() == nao.indices() &&
+                 juntos[2].indices() == e.indices(),
+             "avaliarJuntos igual à avaliação separada");
+
+    // Coluna inexistente
+    bool bLancou = false;
+    try
+    {
+        Predicado::igual("nao_existe", 1).avaliar(nomes, colunas);
+    }
+    catch (const invalid_argument &)
+    {
+        bLancou = true;
+    }
+    verifica(bLancou, "coluna inexistente lança invalid_argument");
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,209 @@
+// Testes do escalonador das etapas (Scheduler) e do encerramento do Manager
+// Compilar a partir desta pasta: g++ -std=c++20 TesteScheduler.cpp -o teste_scheduler -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include "Manager.h"
+#include "Teste.h"
+
+using namespace std;
+
+// Etapa que detecta chamadas de pump simultâneas e termina quando bFim for marcado
+class EtapaContadora : public Stage
+{
+public:
+    atomic<int> iChamadas{0};
+    atomic<bool> bDentro{false}, bSimultanea{false}, bFim{false};
+
+    bool pump() override
+    {
+        if (bDentro.exchange(true))
+            bSimultanea = true;
+        iChamadas++;
+        this_thread::sleep_for(chrono::microseconds(50));
+        bDentro = false;
+        return bFim.load();
+    }
+};
+
+// Etapa que, na primeira chamada, só retorna depois de bLiberada ser marcada
+class EtapaRerun : public Stage
+{
+public:
+    atomic<int> iChamadas{0};
+    atomic<bool> bEntrou{false}, bLiberada{false};
+
+    bool pump() override
+    {
+        if (++iChamadas == 1)
+        {
+            bEntrou = true;
+            while (!bLiberada)
+                this_thread::yield();
+            return false;
+        }
+        return true;
+    }
+};
+
+// Pool de threads mínima sobre uma TaskQueue
+struct Pool
+{
+    TaskQueue fila;
+    vector<thread> threads;
+
+    explicit Pool(int n) : fila(n)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            threads.emplace_back([this, i]
+                                 {
+                fila.registerWorker(i);
+                while (auto tarefa = fila.pop_task())
+                    tarefa(); });
+        }
+    }
+
+    ~Pool()
+    {
+        fila.shutdown();
+        for (auto &t : threads)
+            t.join();
+    }
+};
+
+// Transformador que só repassa os batches
+class Repassa : public Transformer<Dataframe>
+{
+public:
+    using Transformer::Transformer;
+    Dataframe run(vector<Dataframe *> input) override { return std::move(*input[0]); }
+};
+
+// Carregador que conta as linhas recebidas
+class Contador : public Loader<Dataframe>
+{
+public:
+    using Loader::Loader;
+    atomic<int> iLinhas{0};
+    void run(Dataframe df) override { iLinhas += df.getShape().first; }
+};
+
+// Extrator -> repassa (2 saídas) -> repassa -> carregador, em cada saída: 6 etapas numa pool de 2 threads
+bool rodaGrafo(const string &strCsv, int iEsperadas, shared_ptr<SchedulingPolicy> politica)
+{
+    Manager<Dataframe> manager(2);
+    manager.setSchedulingPolicy(std::move(politica));
+    Extrator<Dataframe> extrator(strCsv, "memo", 100);
+    manager.addExtractor(&extrator);
+    Repassa divide(2);
+    divide.addInputBuffer(&extrator.get_output_buffer());
+    manager.addTransformer(&divide);
+    Repassa esquerda, direita;
+    esquerda.addInputBuffer(&divide.get_output_buffer_by_index(0));
+    direita.addInputBuffer(&divide.get_output_buffer_by_index(1));
+    manager.addTransformer(&esquerda);
+    manager.addTransformer(&direita);
+    Contador contaEsquerda(esquerda.get_output_buffer()), contaDireita(direita.get_output_buffer());
+    manager.addLoader(&contaEsquerda);
+    manager.addLoader(&contaDireita);
+
+    // run só retorna depois de todas as etapas terminarem, e stop depois disso não espera de novo
+    manager.run();
+    manager.stop();
+    return contaEsquerda.iLinhas == iEsperadas && contaDireita.iLinhas == iEsperadas;
+}
+
+int main()
+{
+    // Vários despertares enquanto a etapa roda: nunca duas chamadas de pump ao mesmo tempo
+    {
+        Pool pool(4);
+        Scheduler escalonador(&pool.fila);
+        EtapaContadora etapa;
+        escalonador.addStage(&etapa);
+        escalonador.start();
+        vector<thread> acordam;
+        for (int t = 0; t < 4; t++)
+            acordam.emplace_back([&]
+                                 { for (int i = 0; i < 2000; i++) etapa.wakeUp(); });
+        for (auto &t : acordam)
+            t.join();
+        etapa.bFim = true;
+        etapa.wakeUp();
+        escalonador.wait();
+        int iChamadas = etapa.iChamadas;
+        verifica(!etapa.bSimultanea, "no máximo um pump por etapa");
+        verifica(iChamadas >= 1 && iChamadas <= 8002, "no máximo uma chamada por despertar");
+
+        // Etapa terminada ignora novos despertares
+        etapa.wakeUp();
+        this_thread::sleep_for(chrono::milliseconds(20));
+        verifica(etapa.iChamadas == iChamadas, "etapa terminada não é despachada");
+    }
+
+    // Despertares durante o pump fazem a etapa rodar de novo uma única vez
+    {
+        Pool pool(1);
+        Scheduler escalonador(&pool.fila);
+        EtapaRerun etapa;
+        escalonador.addStage(&etapa);
+        escalonador.start();
+        while (!etapa.bEntrou)
+            this_thread::yield();
+        for (int i = 0; i < 100; i++)
+            etapa.wakeUp();
+        etapa.bLiberada = true;
+        escalonador.wait();
+        verifica(etapa.iChamadas == 2, "Running -> Rerun -> Queued");
+    }
+
+    // Grafo com mais etapas que threads roda até o fim com qualquer política
+    string strCsv = "id,valor\n";
+    for (int i = 0; i < 5000; i++)
+        strCsv += to_string(i) + "," + to_string(i % 7) + "\n";
+    verifica(rodaGrafo(strCsv, 5000, make_shared<FifoPolicy>()), "grafo completo com FifoPolicy");
+    verifica(rodaGrafo(strCsv, 5000, make_shared<SinkFirstPolicy>()), "grafo completo com SinkFirstPolicy");
+    verifica(rodaGrafo(strCsv, 5000, make_shared<CriticalPathPolicy>()), "grafo completo com CriticalPathPolicy");
+    verifica(rodaGrafo(strCsv, 5000, make_shared<BackpressurePolicy>(0.2)), "grafo completo com BackpressurePolicy");
+
+    // Faixas de prioridade: a mais alta primeiro, em ordem de chegada dentro de cada faixa
+    {
+        TaskQueue fila(0, 3);
+        string strOrdem;
+        auto tarefa = [&](char c)
+        { return [&strOrdem, c]
+          { strOrdem += c; }; };
+        fila.push_task(tarefa('a'), 0);
+        fila.push_task(tarefa('b'), 2);
+        fila.push_task(tarefa('c'), 1);
+        fila.push_task(tarefa('d'), 2);
+        fila.push_task(tarefa('e'), 99); // Limitada à faixa mais alta
+        fila.push_task(tarefa('f'), -1); // Limitada à faixa mais baixa
+        while (!fila.is_empty())
+            fila.pop_task()();
+        verifica(strOrdem == "bdecaf", "ordem das faixas de prioridade");
+    }
+
+    // Prioridade dada por cada política a partir da situação da etapa
+    StageInfo extrator{3, 5, 0.0, 0.0, 4}, perto{1, 1, 0.9, 0.0, 4}, loader{0, 0, 0.1, 0.0, 4};
+    verifica(FifoPolicy().priority(extrator) == 0 && FifoPolicy().priority(loader) == 0, "FifoPolicy");
+    verifica(SinkFirstPolicy().priority(loader) == 3 && SinkFirstPolicy().priority(perto) == 2 &&
+                 SinkFirstPolicy().priority(extrator) == 0,
+             "SinkFirstPolicy");
+    verifica(CriticalPathPolicy().priority(extrator) == 3 && CriticalPathPolicy().priority(perto) == 1 &&
+                 CriticalPathPolicy().priority(loader) == 0,
+             "CriticalPathPolicy");
+    verifica(BackpressurePolicy(0.5).priority(perto) == 3 && BackpressurePolicy(0.5).priority(extrator) == 0,
+             "BackpressurePolicy");
+
+    // Manager que nunca rodou encerra sem esperar (o destrutor chama stop)
+    {
+        Manager<Dataframe> manager(3);
+    }
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,36 @@
+// Testes da leitura tipada dos campos extraídos (setSchema/inferSchema)
+// Compilar a partir desta pasta: g++ -std=c++20 TesteSchema.cpp -o teste_schema -lsqlite3 -pthread
+#include <iostream>
+#include <string>
+#include "BaseClasses.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    // Depois da amostra de 10 linhas, um real numa coluna inferida como int
+    string strLinhas;
+    for (int i = 0; i < 100; i++)
+        strLinhas += to_string(i) + "," + (i == 50 ? string("2.5") : to_string(i % 7)) + ",x" + to_string(i) + "\n";
+    Extrator<Dataframe> extrator("id,valor,nome\n" + strLinhas, "memo", 100);
+    extrator.inferSchema(10);
+    verifica(extrator.getSchema() == vector<string>{"int", "int", "string"}, "tipos inferidos da amostra");
+
+    Dataframe df = extrator.run(strLinhas);
+    verifica(df.getShape().first == 99 && df.columns[1].isInt(), "linha fora do tipo inferido descartada");
+    verifica(extrator.getLinhasForaDoSchema() == 1, "descarte contado em getLinhasForaDoSchema");
+
+    // Com o tipo declarado, a mesma linha é lida
+    extrator.setSchema({{"id", "int"}, {"valor", "double"}});
+    df = extrator.run(strLinhas);
+    verifica(df.getShape().first == 100 && df.columns[1].isDouble() && df.columns[1].getDouble(50) == 2.5,
+             "tipo declarado com setSchema");
+    verifica(extrator.getLinhasForaDoSchema() == 1, "nenhum novo descarte");
+
+    // Campos vazios descartam a linha sem contar como valor fora do schema
+    df = extrator.run("1,,a\n2,3,b\n");
+    verifica(df.getShape().first == 1 && extrator.getLinhasForaDoSchema() == 1, "campo vazio");
+
+    return resultadoDosTestes();
+}
@@ -0,0 +1,88 @@
+// Testes do deque de roubo de tarefas
+// Compilar a partir desta pasta: g++ -std=c++20 TesteWorkStealingDeque.cpp -o teste_deque -pthread
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "WorkStealingDeque.h"
+#include "Teste.h"
+
+using namespace std;
+
+int main()
+{
+    // Dono retira em ordem LIFO, ladrão em ordem FIFO
+    {
+        WorkStealingDeque<int> deque(4);
+        for (int i = 0; i < 3; i++)
+            deque.push(i);
+        int valor = -1;
+        verifica(deque.pop(valor) && valor == 2, "pop retira o último inserido");
+        verifica(deque.steal(valor) && valor == 0, "steal retira o primeiro inserido");
+        verifica(deque.pop(valor) && valor == 1, "pop do último elemento");
+        verifica(!deque.pop(valor) && !deque.steal(valor) && deque.empty(), "deque vazio");
+    }
+
+    // O vetor circular cresce sem perder elementos, inclusive depois de dar a volta
+    {
+        WorkStealingDeque<int> deque(4);
+        int valor;
+        for (int i = 0; i < 3; i++)
+        {
+            deque.push(i);
+            deque.steal(valor);
+        }
+        for (int i = 0; i < 100; i++)
+            deque.push(i);
+        bool emOrdem = true;
+        for (int i = 0; i < 100; i++)
+            emOrdem = emOrdem && deque.steal(valor) && valor == i;
+        verifica(emOrdem, "crescimento mantém todos os elementos em ordem");
+    }
+
+    // Dono inserindo e retirando enquanto três ladrões roubam: cada elemento sai uma única vez
+    {
+        const int iTotal = 200000;
+        const int iLadroes = 3;
+        WorkStealingDeque<int> deque(16);
+        vector<atomic<int>> vezes(iTotal);
+        atomic<bool> fim{false};
+
+        vector<thread> ladroes;
+        for (int l = 0; l < iLadroes; l++)
+        {
+            ladroes.emplace_back([&]
+                                 {
+                int valor;
+                while (!fim.load())
+                {
+                    if (deque.steal(valor))
+                        vezes[valor]++;
+                } });
+        }
+
+        int valor;
+        for (int i = 0; i < iTotal; i++)
+        {
+            deque.push(i);
+            if (i % 3 == 0 && deque.pop(valor))
+                vezes[valor]++;
+        }
+        while (deque.pop(valor))
+            vezes[valor]++;
+        // Espera os roubos em andamento antes de conferir
+        while (!deque.empty())
+            this_thread::yield();
+        fim = true;
+        for (auto &ladrao : ladroes)
+            ladrao.join();
+
+        bool umaVez = true;
+        for (int i = 0; i < iTotal; i++)
+            umaVez = umaVez && vezes[i].load() == 1;
+        verifica(umaVez, "cada elemento retirado exatamente uma vez sob concorrência");
+    }
+
+    return resultadoDosTestes();
+}
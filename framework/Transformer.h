@@ -4,6 +4,8 @@
 #include "Buffer.h"
 #include "Dataframe.h"
 #include "TaskQueue.h"
+#include "Metrics.h"
+#include "Scheduler.h"
 #include <utility>  // Para std::forward
 #include <tuple>
 #include <optional>
@@ -13,20 +15,19 @@
 #include <vector>
 #include <fstream>
 #include <map>
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <algorithm>
 #include <regex>
 #include <sstream>
 #include <any>
 #include "Series.h"
 
-// Função para renomear uma coluna
-string rename_column(string str1, string str2){
-    return str1;
-}
-
 // Classe base genérica para transformação de dados em um pipeline paralelo
 // T: Tipo dos dados processados (ex: Dataframe, estrutura customizada, etc.)
 template <typename T>
-class Transformer {
+class Transformer : public Stage {
 protected:
     // Buffers de entrada (ponteiros, pois podem ser compartilhados entre componentes)
     std::vector<Buffer<T>*> input_buffers;
@@ -46,14 +47,68 @@ protected:
 
     // Histórico de dataframes usados nas transformações, útil quando há múltiplas entradas
     std::vector<T> historyDataframes;
-    // Vetor das estatísticas internas do transformer
-    std::vector<float> stats;
+    // Vetor das estatísticas posicionais de calculateStats (as declaradas ficam em `metrics`)
+    std::vector<double> stats;
     // Mutexes para a atualização das estatísticas e dos dataframes de histórico
     std::mutex statsMtx;
     std::mutex dfsMtx;
 
-    // Número de tasks que ainda estão na fila de tarefas
-    Semaphore tasksInTaskQueue;
+    // Se true, cada batch de uma entrada é processado junto com o histórico das outras
+    // entradas; se false, as outras posições de `run` recebem nullptr (ver HashJoinTransformer)
+    bool historyEnabled = true;
+
+    // Colunas lidas pela etapa e se as colunas de entrada seguem para a saída (ver declareColumns)
+    std::vector<std::string> readColumns;
+    bool columnsDeclared = false;
+    bool passesColumnsThrough = true;
+
+    // Se true, a saída pode seguir com a seleção de Dataframe::filtra sem ser compactada
+    // (todos os consumidores sabem percorrer a seleção; ver acceptsSelection)
+    bool outputAcceptsSelection = false;
+
+    // Estatística declarada (ver addCounter/addSum/addHistogram): contagem de linhas, soma ou
+    // histograma de uma coluna, opcionalmente restrita às linhas de um predicado
+    struct DeclaredStat {
+        int metric;             // identificador em `metrics`
+        std::string column;     // vazio para contadores
+        int predicate = -1;     // índice em statPredicates, ou -1 para todas as linhas
+    };
+    std::vector<DeclaredStat> declaredStats;
+    std::vector<Predicado> statPredicates;
+    // Índice em statPredicates do filtro declarado da etapa (ver setFilter), ou -1
+    int filterPredicate = -1;
+    // Métricas nomeadas da etapa, com um shard por thread da pool (ver Metrics)
+    Metrics metrics;
+
+    // Retorna se todos os buffers de entrada terminaram
+    bool inputsFinished() const {
+        for (auto* buffer : input_buffers) {
+            if (!buffer->is_finished()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reserva uma vaga em cada buffer de saída, sem bloquear; se algum estiver cheio, devolve as já reservadas
+    bool reserveOutputSlots() {
+        for (int i = 0; i < numOutputBuffers; i++) {
+            if (!output_buffers[i].try_reserve_slot()) {
+                for (int j = 0; j < i; j++) {
+                    output_buffers[j].cancel_reservation();
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Devolve a vaga reservada em cada buffer de saída
+    void cancelOutputSlots() {
+        for (int i = 0; i < numOutputBuffers; i++) {
+            output_buffers[i].cancel_reservation();
+        }
+    }
 
 private:
     // Método para fazer a atualização das estatísticas
@@ -66,12 +121,100 @@ private:
             stats.resize(newStats.size());
         }
         // Incrementa os valores
-        for (int i = 0; i < stats.size(); i++)
+        for (size_t i = 0; i < stats.size(); i++)
         {
             stats[i] += newStats[i];
         }
     }
 
+    // Avalia as estatísticas declaradas e o filtro declarado sobre um batch em uma única
+    // passada: os predicados são avaliados juntos (subexpressões comuns uma vez só), cada
+    // estatística é uma contagem de bits, uma soma ou um histograma das linhas selecionadas,
+    // e a seleção do filtro é aplicada ao batch (Dataframe::filtra)
+    void applyDeclared(T& batch, bool countStats)
+    {
+        if (!countStats)
+        {
+            // Só o filtro (as estatísticas contam apenas os batches da entrada 0)
+            batch.filtra(statPredicates[filterPredicate]);
+            return;
+        }
+
+        std::vector<Selecao> selections = Predicado::avaliarJuntos(statPredicates, batch.vstrColumnsName, batch.columns);
+        if (batch.temSelecao())
+        {
+            for (auto& selection : selections)
+            {
+                selection &= batch.selecao();
+            }
+        }
+        accumulateDeclaredStats(batch, selections);
+        if (filterPredicate >= 0)
+        {
+            batch.filtra(std::move(selections[filterPredicate]));
+        }
+    }
+
+    // Acumula as estatísticas declaradas a partir das seleções dos seus predicados
+    void accumulateDeclaredStats(const T& batch, const std::vector<Selecao>& selections)
+    {
+        int64_t nRows = batch.getShape().first;
+        for (const DeclaredStat& stat : declaredStats)
+        {
+            const Selecao* selection = stat.predicate >= 0 ? &selections[stat.predicate]
+                                     : batch.temSelecao() ? &batch.selecao() : nullptr;
+            if (stat.column.empty())
+            {
+                metrics.increment(stat.metric, selection ? static_cast<int64_t>(selection->contagem()) : nRows);
+                continue;
+            }
+
+            auto it = std::find(batch.vstrColumnsName.begin(), batch.vstrColumnsName.end(), stat.column);
+            if (it == batch.vstrColumnsName.end())
+            {
+                throw std::invalid_argument("Coluna '" + stat.column + "' não encontrada.");
+            }
+            std::vector<double> values = batch.columns[std::distance(batch.vstrColumnsName.begin(), it)].toDoubleVector();
+            auto forEachRow = [&](auto&& f)
+            {
+                if (selection)
+                {
+                    selection->paraCada(f);
+                }
+                else
+                {
+                    for (size_t i = 0; i < values.size(); i++) f(i);
+                }
+            };
+
+            if (metrics.kind(stat.metric) == Metrics::Kind::Histogram)
+            {
+                forEachRow([&](size_t i) { metrics.observe(stat.metric, values[i]); });
+            }
+            else
+            {
+                double sum = 0.0;
+                forEachRow([&](size_t i) { sum += values[i]; });
+                metrics.accumulate(stat.metric, sum);
+            }
+        }
+    }
+
+    // Registra uma estatística declarada e devolve o identificador da métrica
+    int declareStat(int metric, const std::string& column, const std::optional<Predicado>& predicate)
+    {
+        DeclaredStat stat;
+        stat.metric = metric;
+        stat.column = column;
+        if (predicate)
+        {
+            stat.predicate = statPredicates.size();
+            statPredicates.push_back(*predicate);
+        }
+        declaredStats.push_back(stat);
+        return metric;
+    }
+
 public:
     /**
      * Construtor do Transformer
@@ -106,108 +249,76 @@ public:
     }
 
     /**
-     * Método principal que enfileira as tarefas na fila de execução.
-     * Realiza o controle de semáforos, histórico e empacotamento das entradas para processar.
+     * Enfileira uma tarefa para cada entrada disponível, sem bloquear (ver Stage).
+     * Cada tarefa já sai com uma vaga reservada em todos os buffers de saída, de modo que
+     * nenhuma thread da pool fica presa esperando espaço: se alguma saída estiver cheia,
+     * a etapa para e é acordada quando o consumidor liberar uma vaga.
+     * @return true quando as entradas acabaram, as tarefas terminaram e as saídas foram fechadas
      */
-    virtual void enqueue_tasks() {
+    bool pump() override {
         // Inicializa o histórico de entradas se houver mais de um buffer de entrada
-        if (numInputBuffers > 1) {
+        if (numInputBuffers > 1 && historyEnabled && historyDataframes.empty()) {
             historyDataframes.resize(numInputBuffers);
         }
 
-        while (true) {
-            // Verifica se ainda existem dados nos buffers de entrada
-            bool canContinue = false;
-            for (int i = 0; i < input_buffers.size(); i++) {
-                if (!input_buffers[i]->atomicGetInputDataFinished()) {
-                    canContinue = true;
+        while (!inputsFinished()) {
+            // Reserva a vaga da próxima tarefa em todos os buffers de saída
+            if (!reserveOutputSlots()) {
+                return false;
+            }
 
+            // Tenta extrair dados de algum buffer de entrada
+            std::optional<T> maybe_value;
+            int currentInputBuffer = -1;
+            for (int i = 0; i < numInputBuffers; i++) {
+                maybe_value = input_buffers[i]->pop(true);
+                if (maybe_value.has_value()) {
+                    currentInputBuffer = i;
+                    break;
                 }
             }
 
-            // Se ainda tiver dados...
-            if (canContinue) {
-                // Verifica se todos os buffers de saída possuem espaço disponível
-                bool canSendTask = true;
-                for (int i = 0; i < numOutputBuffers; i++) {
-                    if (get_output_buffer_by_index(i).get_semaphore().get_count() <= 0) {
-                        canSendTask = false;
-                        break;
-                    }
-                }
+            // Nada disponível por enquanto: a etapa é acordada quando chegar algo
+            if (!maybe_value.has_value()) {
+                cancelOutputSlots();
+                break;
+            }
 
-                // Se todos tiverem...
-                if (canSendTask) {
-                    std::optional<T> maybe_value;
-                    int currentInputBuffer = -1;
-
-                    // Tenta extrair dados de algum buffer de entrada
-                    for (int i = 0; i < numInputBuffers; i++) {
-                        maybe_value = input_buffers[i]->pop(numInputBuffers > 1);
-                        if (maybe_value.has_value()) {
-                            currentInputBuffer = i;
-                            break;
-                        }
-                    }
+            T value = std::move(*maybe_value);
 
-                    // Caso não tenha encontrado,fica esperando no primeiro buffer não finalizado
-                    if (!maybe_value.has_value() && numInputBuffers > 1) {
-                        for (int i = 0; i < numInputBuffers; i++) {
-                            if (!input_buffers[i]->atomicGetInputDataFinished()) {
-                                maybe_value = input_buffers[i]->pop();
-                                currentInputBuffer = i;
-                                break;
-                            }
-                        }
-                    }
+            // Armazena o histórico se houver múltiplas entradas
+            if (numInputBuffers > 1 && historyEnabled) {
+                std::lock_guard<std::mutex> lock(dfsMtx);
+                historyDataframes[currentInputBuffer].hStack(value);
+            }
 
-                    // Se conseguiu extrair algo
-                    if (maybe_value.has_value()) {
-                        T value = std::move(*maybe_value);
-
-                        // Armazena o histórico se houver múltiplas entradas
-                        if (numInputBuffers > 1) {
-                            {
-                                std::lock_guard<std::mutex> lock(dfsMtx);
-                                historyDataframes[currentInputBuffer].hStack(value);
-                            }
-                        }
-
-                        // Prepara argumentos para a transformação
-                        std::vector<std::shared_ptr<T>> args(numInputBuffers);
-                        for (int i = 0; i < numInputBuffers; i++) {
-                            if (i == currentInputBuffer) {
-                                args[i] = std::make_shared<T>(std::move(value));
-                            } else {
-                                args[i] = std::make_shared<T>(historyDataframes[i]);
-                            }
-                        }
-
-                        // Enfileira tarefa na fila de execução
-                        taskqueue->push_task([this, args = std::move(args)]() mutable {
-                            std::vector<T*> raw_args;
-                            for (auto& ptr : args) {
-                                raw_args.push_back(ptr.get());
-                            }
-                            this->create_task(std::move(raw_args));
-                        });
-
-                        // Incrementa o número de tarefas na task queue
-                        tasksInTaskQueue.notify();
-                    }
+            // Prepara argumentos para a transformação
+            std::vector<std::shared_ptr<T>> args(numInputBuffers);
+            for (int i = 0; i < numInputBuffers; i++) {
+                if (i == currentInputBuffer) {
+                    args[i] = std::make_shared<T>(std::move(value));
+                } else if (historyEnabled) {
+                    args[i] = std::make_shared<T>(historyDataframes[i]);
                 }
-            } else {
-                // Nenhum dado restante nos buffers de entrada
-                break;
             }
-        }
 
-        // Espera todas as tarefas serem processadas
-        while (tasksInTaskQueue.get_count() > 0) {}
+            // Conta a tarefa antes de enfileirá-la, para que ela nunca termine antes de ser contada
+            taskCreated();
+            taskqueue->push_task([this, args = std::move(args), currentInputBuffer]() mutable {
+                std::vector<T*> raw_args;
+                for (auto& ptr : args) {
+                    raw_args.push_back(ptr.get());
+                }
+                this->create_task(std::move(raw_args), currentInputBuffer);
+            }, priority());
+        }
 
-        // Finaliza os buffers de saída após o fim do processamento
+        // Termina quando as entradas acabaram e todas as tarefas foram processadas
+        if (!inputsFinished() || hasRunningTasks()) {
+            return false;
+        }
         finishBuffer();
-
+        return true;
     }
 
     /**
@@ -223,44 +334,151 @@ public:
         return std::vector<float>{};
     };
 
-    // Getter das estatísticas
+    /**
+     * @brief Declara um contador de linhas, calculado pelo framework a cada batch da entrada 0.
+     *
+     * Todas as estatísticas declaradas são avaliadas juntas, em uma passada por batch, e
+     * acumuladas em shards por thread (ver Metrics), sem o mutex de `calculateStats`.
+     * Devem ser declaradas antes de o pipeline começar a rodar.
+     * @param name - nome da estatística (ver getCounter)
+     * @param predicate - se informado, conta só as linhas que o satisfazem
+     * @return identificador da métrica
+     */
+    int addCounter(const std::string& name, const std::optional<Predicado>& predicate = std::nullopt)
+    {
+        return declareStat(metrics.addCounter(name), "", predicate);
+    }
+
+    /**
+     * @brief Declara a soma de uma coluna, calculada como os contadores de addCounter.
+     * @param name - nome da estatística (ver getSum)
+     * @param column - coluna somada (strings não numéricas contam como 0)
+     * @param predicate - se informado, soma só as linhas que o satisfazem
+     * @return identificador da métrica
+     */
+    int addSum(const std::string& name, const std::string& column, const std::optional<Predicado>& predicate = std::nullopt)
+    {
+        return declareStat(metrics.addSum(name), column, predicate);
+    }
+
+    /**
+     * @brief Declara um histograma dos valores de uma coluna.
+     * @param name - nome da estatística (ver getHistogram)
+     * @param column - coluna observada
+     * @param bounds - limites superiores das faixas (há uma faixa extra para valores acima do último)
+     * @param predicate - se informado, observa só as linhas que o satisfazem
+     * @return identificador da métrica
+     */
+    int addHistogram(const std::string& name, const std::string& column, std::vector<double> bounds,
+                     const std::optional<Predicado>& predicate = std::nullopt)
+    {
+        return declareStat(metrics.addHistogram(name, std::move(bounds)), column, predicate);
+    }
+
+    /**
+     * @brief Declara o filtro da etapa: só as linhas que satisfazem o predicado chegam a `run`.
+     *
+     * O predicado é avaliado junto com os das estatísticas declaradas, na mesma passada
+     * (subexpressões comuns, como `ocupado == 0` e a sua negação, uma vez só), e a seleção é
+     * aplicada à entrada 0 com Dataframe::filtra antes de `run`. As estatísticas continuam
+     * vendo todas as linhas do batch. Deve ser chamado antes de o pipeline começar a rodar.
+     * @param predicate - predicado das linhas mantidas
+     */
+    void setFilter(const Predicado& predicate)
+    {
+        if (filterPredicate < 0)
+        {
+            filterPredicate = statPredicates.size();
+            statPredicates.push_back(predicate);
+        }
+        else
+        {
+            statPredicates[filterPredicate] = predicate;
+        }
+    }
+
+    // Getters tipados das estatísticas declaradas (somam os shards das threads)
+    int64_t getCounter(const std::string& name) const { return metrics.counter(name); }
+    double getSum(const std::string& name) const { return metrics.sum(name); }
+    std::vector<int64_t> getHistogram(const std::string& name) const { return metrics.histogram(name); }
+
+    // Registro de métricas da etapa, para métricas atualizadas diretamente em `run`
+    Metrics& getMetrics() { return metrics; }
+
+    // Getter das estatísticas posicionais: as de calculateStats seguidas das declaradas,
+    // na ordem de declaração (prefira os getters tipados acima)
     std::vector<float> getStats()
     {
-        std::lock_guard<std::mutex> lock(statsMtx);
-        return stats;
+        std::vector<float> result;
+        {
+            std::lock_guard<std::mutex> lock(statsMtx);
+            result.assign(stats.begin(), stats.end());
+        }
+        for (const DeclaredStat& stat : declaredStats)
+        {
+            result.push_back(static_cast<float>(metrics.value(stat.metric)));
+        }
+        return result;
     }
 
     /**
      * @brief Envolve a execução de `run` e o envio dos dados para os buffers de saída.
      * @param value - vetor de ponteiros para os dados de entrada
      */
-    void create_task(std::vector<T*> value) {
+    void create_task(std::vector<T*> value, int inputIndex = 0) {
+        // Estatísticas e filtro declarados: avaliados antes de `run`, que pode mover a entrada.
+        // As estatísticas só contam os batches da entrada 0 (com histórico, value[0] também é
+        // preenchido quando o batch veio de outra entrada)
+        bool countStats = !declaredStats.empty() && inputIndex == 0;
+        if (value[0] != nullptr && (countStats || filterPredicate >= 0))
+        {
+            applyDeclared(*value[0], countStats);
+        }
+
         // Calcula e agrega as estatísticas
         std::vector<float> currentStats = calculateStats(value);
-        aggStats(currentStats);
+        if (!currentStats.empty())
+        {
+            aggStats(currentStats);
+        }
         
         T data = run(value);
-        
-        if (data.getShape().first > 0)
+
+        // Só copia as linhas selecionadas se algum consumidor não souber ler a seleção
+        if (!outputAcceptsSelection)
+        {
+            data.compacta();
+        }
+
+        if (data.iLinhasSelecionadas() > 0)
         {
             // cout << data << endl;
             for (int i = 0; i < numOutputBuffers; i++) {
-                // Incrementa o semáforo e espera até que tenha vaga
-                get_output_buffer_by_index(i).get_semaphore().wait();
-                // Coloca no buffer
-                get_output_buffer_by_index(i).push(data);
+                // Coloca na vaga reservada em pump: o último recebe o próprio batch, os anteriores uma cópia
+                if (i + 1 < numOutputBuffers) {
+                    get_output_buffer_by_index(i).push(T(data));
+                } else {
+                    get_output_buffer_by_index(i).push(std::move(data));
+                }
             }
         }
+        else
+        {
+            // Sem linhas: devolve as vagas reservadas
+            cancelOutputSlots();
+        }
 
-        // Incrementa o número de tarefas na fila
-        tasksInTaskQueue.wait();
-       
+        taskDone();
     }
 
     virtual ~Transformer() = default;
 
     // Setter da fila de tarefas
-    void set_taskqueue(TaskQueue* tq) { taskqueue = tq; }
+    void set_taskqueue(TaskQueue* tq)
+    {
+        taskqueue = tq;
+        metrics.attach(tq);
+    }
 
     // Getter da fila de tarefas
     TaskQueue* get_taskqueue() const { return taskqueue; }
@@ -270,7 +488,7 @@ public:
      */
     virtual void finishBuffer() {
         for (int i = 0; i < numOutputBuffers; i++) {
-            get_output_buffer_by_index(i).finalizeInput();
+            get_output_buffer_by_index(i).close();
         }
     }
 
@@ -280,6 +498,314 @@ public:
         input_buffers.push_back(buffer);
         numInputBuffers++;
     }
+
+    // Getter dos buffers de entrada
+    virtual std::vector<Buffer<T>*> get_input_buffers() const { return input_buffers; }
+
+    // Getter do número de buffers de saída
+    int get_num_output_buffers() const { return numOutputBuffers; }
+
+    /**
+     * @brief Declara as colunas que a etapa lê das entradas, para a poda de colunas do Manager.
+     *
+     * Sem essa declaração, o Manager considera que a etapa precisa de todas as colunas.
+     * @param reads - colunas lidas por `run` e `calculateStats`
+     * @param passesThrough - se true, as colunas de entrada seguem para a saída (filtros,
+     *        colunas calculadas) e as colunas exigidas pelas etapas seguintes também são exigidas
+     *        da entrada; se false, a saída é formada só a partir de `reads` (agregações)
+     */
+    void declareColumns(const std::vector<std::string>& reads, bool passesThrough = true)
+    {
+        readColumns = reads;
+        columnsDeclared = true;
+        passesColumnsThrough = passesThrough;
+    }
+
+    // Getters da declaração de colunas
+    bool hasDeclaredColumns() const { return columnsDeclared; }
+    const std::vector<std::string>& getReadColumns() const { return readColumns; }
+    bool getPassesColumnsThrough() const { return passesColumnsThrough; }
+
+    /**
+     * @brief Indica se a etapa processa entradas com seleção pendente (Dataframe::filtra)
+     * sem precisar que elas sejam compactadas antes.
+     */
+    virtual bool acceptsSelection() const { return false; }
+
+    // Setter do repasse da seleção para a saída (definido pelo Manager)
+    void setOutputAcceptsSelection(bool accepts) { outputAcceptsSelection = accepts; }
+};
+
+// Classe do transformador de junção por hash simétrica (streaming)
+//
+// Mantém, para cada uma das duas entradas, todas as linhas já recebidas e um índice hash
+// das suas chaves. Cada novo batch é comparado apenas com o índice do outro lado e depois
+// inserido no índice do seu lado, de modo que cada par de linhas correspondentes é emitido
+// exatamente uma vez e o custo total é linear no número de linhas (sem reprocessar histórico).
+// O resultado tem o mesmo layout de Dataframe::merge: todas as colunas da entrada 0 seguidas
+// das colunas da entrada 1 que não são chave.
+template <typename T>
+class HashJoinTransformer : public Transformer<T> {
+private:
+    // Estado de um lado da junção
+    struct Side {
+        T rows;                                                  // Linhas já recebidas
+        std::vector<int> keyIdx;                                 // Índices das colunas-chave
+        std::unordered_map<uint64_t, std::vector<size_t>> index; // Hash da chave -> linhas
+        bool initialized = false;
+    };
+
+    std::vector<std::string> keys;
+    // Chaves comparadas como texto (getAsString) porque os lados têm tipos diferentes
+    std::vector<bool> keyAsText;
+    Side sides[2];
+    // Um único mutex serializa os dois lados: o batch de um lado lê o índice do outro e
+    // escreve no seu, e a reconstrução dos índices (ver run) mexe nos dois
+    std::mutex joinMtx;
+
+    // Índices das colunas-chave num dataframe (false se alguma não existir)
+    bool keyIndices(const T& df, std::vector<int>& idx) const
+    {
+        idx.clear();
+        for (const auto& key : keys)
+        {
+            auto it = std::find(df.vstrColumnsName.begin(), df.vstrColumnsName.end(), key);
+            if (it == df.vstrColumnsName.end())
+            {
+                std::cerr << "Coluna-chave '" << key << "' não encontrada. Batch descartado." << std::endl;
+                return false;
+            }
+            idx.push_back(std::distance(df.vstrColumnsName.begin(), it));
+        }
+        return true;
+    }
+
+    // Hash de 64 bits da chave de cada linha
+    std::vector<uint64_t> keyHashes(const T& df, const std::vector<int>& idx) const
+    {
+        std::vector<uint64_t> hashes(df.getShape().first, 0);
+        for (size_t k = 0; k < idx.size(); k++)
+        {
+            const Column& col = df.columns[idx[k]];
+            // Chave comparada como texto: o hash é o do texto, como em Column::bValorIgual
+            if (keyAsText[k] && col.strGetType() != "string")
+            {
+                col.convertTo("string").combinaHash(hashes);
+            }
+            else
+            {
+                col.combinaHash(hashes);
+            }
+        }
+        return hashes;
+    }
+
+    // Refaz o índice de um lado a partir das linhas guardadas
+    void rebuildIndex(Side& side)
+    {
+        side.index.clear();
+        std::vector<uint64_t> hashes = keyHashes(side.rows, side.keyIdx);
+        for (size_t i = 0; i < hashes.size(); i++)
+        {
+            side.index[hashes[i]].push_back(i);
+        }
+    }
+
+    // Tipo em que valores de dois tipos diferentes podem ser guardados juntos
+    static std::string commonType(const std::string& a, const std::string& b)
+    {
+        bool numeric = (a == "int" || a == "double") && (b == "int" || b == "double");
+        return numeric ? "double" : "string";
+    }
+
+    /**
+     * @brief Deixa o batch com as colunas e os tipos das linhas já guardadas do lado.
+     *
+     * As colunas são reordenadas pelo nome, e as que não existem no lado são descartadas.
+     * Colunas de tipos diferentes passam para o tipo comum (int e double viram double; os
+     * demais viram string), convertendo também a coluna guardada se for preciso. As duas
+     * conversões nunca falham.
+     * @param storedChanged - marcado se alguma coluna guardada mudou de tipo
+     * @return false se faltar ao batch alguma coluna do lado
+     */
+    bool conform(Side& side, T& batch, bool& storedChanged)
+    {
+        if (!side.initialized)
+        {
+            return true;
+        }
+        T& stored = side.rows;
+        if (batch.vstrColumnsName != stored.vstrColumnsName)
+        {
+            T reordered;
+            for (const auto& name : stored.vstrColumnsName)
+            {
+                auto it = std::find(batch.vstrColumnsName.begin(), batch.vstrColumnsName.end(), name);
+                if (it == batch.vstrColumnsName.end())
+                {
+                    std::cerr << "Coluna '" << name << "' não encontrada no batch. Batch descartado." << std::endl;
+                    return false;
+                }
+                reordered.vstrColumnsName.push_back(name);
+                reordered.columns.push_back(std::move(batch.columns[std::distance(batch.vstrColumnsName.begin(), it)]));
+            }
+            batch = std::move(reordered);
+        }
+        for (size_t j = 0; j < stored.columns.size(); j++)
+        {
+            std::string batchType = batch.columns[j].strGetType();
+            std::string storedType = stored.columns[j].strGetType();
+            if (batchType == storedType)
+            {
+                continue;
+            }
+            std::string common = commonType(batchType, storedType);
+            if (batchType != common)
+            {
+                batch.columns[j] = batch.columns[j].convertTo(common);
+            }
+            if (storedType != common)
+            {
+                stored.columns[j] = stored.columns[j].convertTo(common);
+                storedChanged = true;
+            }
+        }
+        return true;
+    }
+
+public:
+    /**
+     * Construtor
+     * @param join_keys - colunas usadas como chave da junção (devem existir nas duas entradas)
+     * @param num_outputs - número de buffers de saída
+     */
+    HashJoinTransformer(const std::vector<std::string>& join_keys, int num_outputs = 1)
+        : Transformer<T>(num_outputs), keys(join_keys), keyAsText(join_keys.size(), false)
+    {
+        this->historyEnabled = false;
+        this->declareColumns(join_keys, true);
+    }
+
+    /**
+     * @brief Junta o novo batch (única posição não nula de `input`) com as linhas do outro lado.
+     *
+     * Batches sem alguma das colunas do seu lado (ou sem as colunas-chave) são descartados
+     * com uma mensagem de erro.
+     * @param input - vetor com duas posições; a posição do lado que recebeu o batch aponta para ele
+     * @return Linhas resultantes da junção do batch com tudo o que já chegou do outro lado
+     */
+    T run(std::vector<T*> input) override {
+        int s = input[0] != nullptr ? 0 : 1;
+        T& batch = *input[s];
+        if (batch.columns.empty())
+        {
+            return T();
+        }
+
+        std::lock_guard<std::mutex> lock(joinMtx);
+        Side& mine = sides[s];
+        Side& other = sides[1 - s];
+
+        bool storedChanged = false;
+        if (!conform(mine, batch, storedChanged))
+        {
+            return T();
+        }
+        if (!mine.initialized && !keyIndices(batch, mine.keyIdx))
+        {
+            return T();
+        }
+
+        // Chaves de tipos diferentes entre os lados passam a ser comparadas como texto
+        bool textChanged = false;
+        if (other.initialized)
+        {
+            for (size_t k = 0; k < keys.size(); k++)
+            {
+                if (!keyAsText[k] && batch.columns[mine.keyIdx[k]].strGetType() !=
+                                         other.rows.columns[other.keyIdx[k]].strGetType())
+                {
+                    keyAsText[k] = true;
+                    textChanged = true;
+                }
+            }
+        }
+        if (mine.initialized && (textChanged || storedChanged))
+        {
+            rebuildIndex(mine);
+        }
+        if (textChanged && other.initialized)
+        {
+            rebuildIndex(other);
+        }
+
+        // Guarda o batch no seu lado; o índice só é atualizado se o batch foi guardado
+        size_t offset = mine.initialized ? mine.rows.getShape().first : 0;
+        if (!mine.rows.hStack(batch))
+        {
+            std::cerr << "Batch descartado pela junção." << std::endl;
+            return T();
+        }
+        mine.initialized = true;
+        std::vector<uint64_t> hashes = keyHashes(batch, mine.keyIdx);
+
+        // Procura as linhas do batch no índice do outro lado
+        std::vector<size_t> batchRows, otherRows;
+        if (other.initialized)
+        {
+            for (size_t i = 0; i < hashes.size(); i++)
+            {
+                auto it = other.index.find(hashes[i]);
+                if (it == other.index.end())
+                    continue;
+                for (size_t j : it->second)
+                {
+                    bool equal = true;
+                    for (size_t k = 0; equal && k < keys.size(); k++)
+                    {
+                        equal = batch.columns[mine.keyIdx[k]].bValorIgual(i, other.rows.columns[other.keyIdx[k]], j);
+                    }
+                    if (equal)
+                    {
+                        batchRows.push_back(i);
+                        otherRows.push_back(j);
+                    }
+                }
+            }
+        }
+
+        // Monta o resultado no layout de merge (lado 0 inteiro + colunas não-chave do lado 1)
+        T result;
+        if (!batchRows.empty())
+        {
+            const T& left = s == 0 ? batch : other.rows;
+            const T& right = s == 0 ? other.rows : batch;
+            const std::vector<size_t>& leftRows = s == 0 ? batchRows : otherRows;
+            const std::vector<size_t>& rightRows = s == 0 ? otherRows : batchRows;
+
+            result.vstrColumnsName = left.vstrColumnsName;
+            for (const auto& col : left.columns)
+            {
+                result.columns.push_back(col.gather(leftRows));
+            }
+            for (size_t j = 0; j < right.vstrColumnsName.size(); j++)
+            {
+                if (std::find(keys.begin(), keys.end(), right.vstrColumnsName[j]) == keys.end())
+                {
+                    result.vstrColumnsName.push_back(right.vstrColumnsName[j]);
+                    result.columns.push_back(right.columns[j].gather(rightRows));
+                }
+            }
+        }
+
+        // Insere o batch no índice do seu lado
+        for (size_t i = 0; i < hashes.size(); i++)
+        {
+            mine.index[hashes[i]].push_back(offset + i);
+        }
+
+        return result;
+    }
 };
 
 // Classe específica do transformador de agrupamento
@@ -295,10 +821,246 @@ private:
     Dataframe aggregated;
     std::mutex mtx;
     Buffer<T>* input_buffer;
-    // Número de tarefas na fila de tarefas
-    Semaphore tasksInTaskQueue;
     // Nome da coluna de count (deve ser passado pelo usuário)
     std::string nameCountColumn;
+
+    // Grupos de uma partição no modo particionado: uma linha por grupo, com as chaves em
+    // colunas tipadas, as somas tipadas e a contagem. Os grupos são indexados pelo hash de
+    // 64 bits da chave (Column::combinaHash); grupos com o mesmo hash são encadeados e
+    // distinguidos comparando as chaves
+    struct PartialTable {
+        std::vector<Column> keyColumns;
+        std::vector<uint64_t> hashes;
+        std::vector<std::vector<int64_t>> intSums;   // Por coluna agregada, a soma de cada grupo
+        std::vector<std::vector<double>> doubleSums;
+        std::vector<int64_t> counts;
+        std::unordered_map<uint64_t, uint32_t> firstGroup; // Hash -> primeiro grupo com esse hash
+        std::vector<uint32_t> nextGroup;                   // Próximo grupo com o mesmo hash
+
+        size_t size() const { return counts.size(); }
+
+        void clear() { *this = PartialTable(); }
+    };
+
+    // Tabelas parciais de uma thread, uma por partição de hash
+    struct LocalState {
+        std::vector<PartialTable> partitions;
+    };
+
+    // Modo de agregação particionada (ver setPartitionedAggregation)
+    bool partitioned = false;
+    int numPartitions = 16;
+    // Estado local de cada thread da pool que processou algum batch
+    std::unordered_map<std::thread::id, std::unique_ptr<LocalState>> localStates;
+    std::mutex localStatesMtx;
+    // Tipos das colunas de agrupamento e de agregação (lidos do primeiro batch)
+    std::vector<std::string> keyTypes;
+    std::vector<std::string> aggTypes;
+
+    // Fases da etapa em pump: agrega os batches, junta as partições e envia o resultado
+    enum class Phase { Aggregating, Merging, Sending };
+    Phase phase = Phase::Aggregating;
+    // Estados das threads e partições montadas durante a junção (ver mergePartitions)
+    std::vector<LocalState*> mergeStates;
+    std::vector<T> mergedParts;
+    // Posição do envio do resultado em batches
+    int nRows = 0;
+    int batchSize = 1;
+    int currentRow = 0;
+
+    // Checa se a operação de agregação foi pedida
+    bool hasOperation(const std::string& op) const
+    {
+        return std::find(operations.begin(), operations.end(), op) != operations.end();
+    }
+
+    // Retorna as tabelas parciais da thread atual, criando-as na primeira chamada
+    LocalState& getLocalState(const T& batch)
+    {
+        std::lock_guard<std::mutex> lock(localStatesMtx);
+        if (keyTypes.empty() && aggTypes.empty())
+        {
+            for (const auto& key : keys) keyTypes.push_back(batch.columns[columnIndex(batch, key)].strGetType());
+            for (const auto& col : columns) aggTypes.push_back(batch.columns[columnIndex(batch, col)].strGetType());
+        }
+        std::unique_ptr<LocalState>& state = localStates[std::this_thread::get_id()];
+        if (!state)
+        {
+            state = std::make_unique<LocalState>();
+            state->partitions.resize(numPartitions);
+        }
+        return *state;
+    }
+
+    // Índice de uma coluna no dataframe
+    static size_t columnIndex(const T& df, const std::string& name)
+    {
+        auto it = std::find(df.vstrColumnsName.begin(), df.vstrColumnsName.end(), name);
+        if (it == df.vstrColumnsName.end())
+        {
+            throw std::invalid_argument("Coluna '" + name + "' não encontrada.");
+        }
+        return std::distance(df.vstrColumnsName.begin(), it);
+    }
+
+    // Retorna o grupo da tabela com a chave da linha `row` de keyCols, criando-o se não existir
+    uint32_t findOrInsertGroup(PartialTable& table, uint64_t h, const std::vector<const Column*>& keyCols, size_t row)
+    {
+        auto sameKey = [&](uint32_t g)
+        {
+            for (size_t k = 0; k < keyCols.size(); k++)
+            {
+                if (!table.keyColumns[k].bValorIgual(g, *keyCols[k], row)) return false;
+            }
+            return true;
+        };
+
+        auto [it, inserted] = table.firstGroup.try_emplace(h, static_cast<uint32_t>(table.size()));
+        uint32_t g = it->second;
+        if (!inserted)
+        {
+            // Percorre a cadeia de grupos com o mesmo hash
+            while (!sameKey(g))
+            {
+                if (table.nextGroup[g] == UINT32_MAX)
+                {
+                    table.nextGroup[g] = static_cast<uint32_t>(table.size());
+                    inserted = true;
+                    break;
+                }
+                g = table.nextGroup[g];
+            }
+            if (!inserted) return g;
+        }
+
+        // Novo grupo: as colunas de chave herdam o tipo (e o dicionário) da primeira origem
+        if (table.keyColumns.empty())
+        {
+            for (const Column* col : keyCols) table.keyColumns.push_back(col->gather({}));
+            table.intSums.resize(columns.size());
+            table.doubleSums.resize(columns.size());
+        }
+        g = static_cast<uint32_t>(table.size());
+        for (size_t k = 0; k < keyCols.size(); k++) table.keyColumns[k].appendFrom(*keyCols[k], row);
+        for (auto& sums : table.intSums) sums.push_back(0);
+        for (auto& sums : table.doubleSums) sums.push_back(0.0);
+        table.counts.push_back(0);
+        table.hashes.push_back(h);
+        table.nextGroup.push_back(UINT32_MAX);
+        return g;
+    }
+
+    // Junta na tabela destino os grupos da tabela origem
+    void mergeTables(PartialTable& target, PartialTable& source)
+    {
+        std::vector<const Column*> keyCols;
+        for (const Column& col : source.keyColumns) keyCols.push_back(&col);
+        for (size_t g = 0; g < source.size(); g++)
+        {
+            uint32_t t = findOrInsertGroup(target, source.hashes[g], keyCols, g);
+            for (size_t j = 0; j < columns.size(); j++)
+            {
+                target.intSums[j][t] += source.intSums[j][g];
+                target.doubleSums[j][t] += source.doubleSums[j][g];
+            }
+            target.counts[t] += source.counts[g];
+        }
+        source.clear();
+    }
+
+    // Monta o dataframe agregado de uma partição (mesmo layout de dfGroupby)
+    T buildPartition(PartialTable& table)
+    {
+        bool sum = hasOperation("sum");
+        bool mean = hasOperation("mean");
+
+        T df;
+        for (size_t k = 0; k < keys.size(); k++)
+        {
+            df.vstrColumnsName.push_back(keys[k]);
+            if (k < table.keyColumns.size())
+                df.columns.push_back(std::move(table.keyColumns[k]));
+            else
+                df.columns.emplace_back(keys[k], keyTypes[k]);
+        }
+        for (size_t j = 0; j < columns.size(); j++)
+        {
+            if (sum)
+            {
+                df.vstrColumnsName.push_back(columns[j] + "_sum");
+                df.columns.emplace_back(columns[j] + "_sum", aggTypes[j] == "int" ? "int" : "double");
+            }
+            if (mean)
+            {
+                df.vstrColumnsName.push_back(columns[j] + "_mean");
+                df.columns.emplace_back(columns[j] + "_mean", "double");
+            }
+        }
+        df.vstrColumnsName.push_back("count");
+        df.columns.emplace_back("count", "int");
+
+        for (size_t c = keys.size(); c < df.columns.size(); c++) df.columns[c].reserve(table.size());
+
+        for (size_t g = 0; g < table.size(); g++)
+        {
+            size_t c = keys.size();
+            for (size_t j = 0; j < columns.size(); j++)
+            {
+                double total = aggTypes[j] == "int" ? static_cast<double>(table.intSums[j][g]) : table.doubleSums[j][g];
+                if (sum)
+                {
+                    if (aggTypes[j] == "int")
+                        df.columns[c++].appendInt(table.intSums[j][g]);
+                    else
+                        df.columns[c++].appendDouble(total);
+                }
+                if (mean)
+                {
+                    df.columns[c++].appendDouble(table.counts[g] > 0 ? total / table.counts[g] : 0.0);
+                }
+            }
+            df.columns[c].appendInt(table.counts[g]);
+        }
+        return df;
+    }
+
+    // Junta as tabelas de todas as threads, em paralelo por partição: cria uma tarefa por
+    // partição, e collectPartitions monta o dataframe agregado quando todas terminarem
+    void mergePartitions()
+    {
+        mergeStates.clear();
+        for (auto& [id, state] : localStates) mergeStates.push_back(state.get());
+        if (mergeStates.empty()) return;
+
+        mergedParts.assign(numPartitions, T());
+        for (int p = 0; p < numPartitions; p++)
+        {
+            this->taskCreated();
+            taskqueue->push_task([this, p]() {
+                PartialTable& target = mergeStates[0]->partitions[p];
+                for (size_t s = 1; s < mergeStates.size(); s++)
+                {
+                    mergeTables(target, mergeStates[s]->partitions[p]);
+                }
+                mergedParts[p] = buildPartition(target);
+                target.clear();
+                this->taskDone();
+            }, this->priority());
+        }
+    }
+
+    // Junta as partições montadas por mergePartitions no dataframe agregado
+    void collectPartitions()
+    {
+        for (auto& part : mergedParts)
+        {
+            aggregated.hStack(part);
+        }
+        mergedParts.clear();
+        mergeStates.clear();
+        localStates.clear();
+    }
+
 public:
     using Transformer<T>::output_buffers;
     using Transformer<T>::taskqueue;
@@ -317,24 +1079,28 @@ public:
         columns(agg_columns),
         operations(agg_ops),
         input_buffer(input_buffer),
-        nameCountColumn(nameCountColumn) {}
+        nameCountColumn(nameCountColumn)
+    {
+        // A saída só tem as chaves e as agregações
+        std::vector<std::string> reads = group_keys;
+        reads.insert(reads.end(), agg_columns.begin(), agg_columns.end());
+        this->declareColumns(reads, false);
+    }
+
+    // O buffer de entrada do agrupador não passa por addInputBuffer
+    std::vector<Buffer<T>*> get_input_buffers() const override { return {input_buffer}; }
+
+    // Os batches filtrados chegam sem cópia: o modo particionado percorre a seleção e o
+    // modo padrão a compacta antes de agregar
+    bool acceptsSelection() const override { return true; }
 
     // Método do processamento da agregação
     T run(std::vector<T*> dataframes) override {
-        // Checa se tem sum entre as agregações
-        bool sum = false;
-        for (int i = 0; i < operations.size(); i++)
-        {
-            if (operations[i] == "sum")
-            {
-                sum = true;
-                break;
-            }
-        }
+        bool sum = hasOperation("sum");
 
-        // Agrega o batch do dataframe recebido
-        Dataframe dataframe = *dataframes[0];
-        Dataframe littleAggregated = dataframe.dfGroupby(keys, columns, sum, false, true);
+        // Agrega o batch do dataframe recebido (sem copiá-lo)
+        dataframes[0]->compacta();
+        Dataframe littleAggregated = dataframes[0]->dfGroupby(keys, columns, sum, false, true);
 
         return littleAggregated;
     }
@@ -342,26 +1108,74 @@ public:
     // Método para criar tasks de agregação de cada batch e união com os anteriores
     void createAggTask(T* value)
     {
-        // Checa se tem sum entre as agregações
-        bool sum = false;
-        for (int i = 0; i < operations.size(); i++)
-        {
-            if (operations[i] == "sum")
-            {
-                sum = true;
-                break;
-            }
-        }
-
         // Agrega o batch
         T littleAggregated = run({value});
         // Junta com o histórico e agrega novamente
         std::lock_guard<std::mutex> lock(mtx);
         aggregated.hStackGroup(littleAggregated);
-        tasksInTaskQueue.wait();
+        this->taskDone();
     }
 
-    // Método para criar as tarefas que enviam o dataframe para o buffer de saída
+    /**
+     * @brief Agrega um batch nas tabelas parciais da thread atual (modo particionado).
+     *
+     * O batch é agregado pelo kernel tipado de dfGroupby (somas e contagem por grupo); cada
+     * grupo resultante vai para a partição escolhida pelo hash de 64 bits da sua chave, onde
+     * é somado ao grupo de mesma chave. Nenhum lock é tomado: as tabelas da thread só são
+     * juntadas no fim, em mergePartitions.
+     * @param value - batch a ser agregado
+     */
+    void createPartitionedAggTask(T* value)
+    {
+        LocalState& state = getLocalState(*value);
+
+        value->compacta();
+        T partial = value->dfGroupby(keys, columns, true, false, true);
+        size_t nGroups = partial.getShape().first;
+
+        // Layout de dfGroupby: chaves, "<coluna>_sum" de cada coluna agregada e "count"
+        std::vector<const Column*> keyCols;
+        std::vector<const Column*> sumCols;
+        for (size_t k = 0; k < keys.size(); k++) keyCols.push_back(&partial.columns[k]);
+        for (size_t j = 0; j < columns.size(); j++) sumCols.push_back(&partial.columns[keys.size() + j]);
+        const Column& countCol = partial.columns.back();
+
+        std::vector<uint64_t> hashes(nGroups, 0);
+        for (const Column* col : keyCols) col->combinaHash(hashes);
+
+        for (size_t i = 0; i < nGroups; i++)
+        {
+            PartialTable& table = state.partitions[(hashes[i] >> 16) % numPartitions];
+            uint32_t g = findOrInsertGroup(table, hashes[i], keyCols, i);
+            for (size_t j = 0; j < sumCols.size(); j++)
+            {
+                if (aggTypes[j] == "int")
+                    table.intSums[j][g] += sumCols[j]->isInt() ? sumCols[j]->getInt(i) : static_cast<int64_t>(sumCols[j]->getAsDouble(i));
+                else
+                    table.doubleSums[j][g] += sumCols[j]->getAsDouble(i);
+            }
+            table.counts[g] += countCol.getInt(i);
+        }
+
+        this->taskDone();
+    }
+
+    /**
+     * @brief Ativa a agregação particionada.
+     *
+     * Em vez de juntar cada batch ao resultado sob um mutex (hStackGroup), cada thread
+     * acumula em tabelas hash próprias, divididas em partições pelo hash da chave; no fim,
+     * cada partição é juntada e convertida em dataframe por uma tarefa separada.
+     * @param enabled - se true, usa a agregação particionada
+     * @param partitions - número de partições de hash
+     */
+    void setPartitionedAggregation(bool enabled, int partitions = 16)
+    {
+        partitioned = enabled;
+        numPartitions = std::max(partitions, 1);
+    }
+
+    // Método que envia um slice do dataframe para os buffers de saída (com as vagas já reservadas)
     void sendData(int startRow, int endRow)
     {
         // Pega um slice do dataframe
@@ -369,58 +1183,76 @@ public:
         
         // Manda para os buffers de saída
         for (int i = 0; i < numOutputBuffers; i++) {
-            // Incrementa o semáforo e espera até que tenha vaga
-            this->get_output_buffer_by_index(i).get_semaphore().wait();
-            this->get_output_buffer_by_index(i).push(slice);
+            // O último buffer recebe o próprio slice, os anteriores uma cópia
+            if (i + 1 < numOutputBuffers) {
+                this->get_output_buffer_by_index(i).push(T(slice));
+            } else {
+                this->get_output_buffer_by_index(i).push(std::move(slice));
+            }
         }
     }
 
-    // Método para criar as tasks
-    void enqueue_tasks() override {
-        while (!(input_buffer -> atomicGetInputDataFinished())) {
-            // Tenta extrair um dado do buffer
-            std::optional<T> maybe_value = input_buffer -> pop();
-
-            // Se não conseguir pegar nenhum dado (buffer vazio no momento), encerra o loop
-            if (!maybe_value.has_value()) {
-                break;
+    // Método para criar as tasks, por fases (ver Stage)
+    bool pump() override {
+        if (phase == Phase::Aggregating) {
+            // Enfileira a agregação de cada batch disponível
+            while (std::optional<T> maybe_value = input_buffer -> pop(true)) {
+                this->taskCreated();
+                if (partitioned) {
+                    taskqueue->push_task([this, val = std::move(*maybe_value)]() mutable {
+                        this->createPartitionedAggTask(&val);
+                    }, this->priority());
+                } else {
+                    taskqueue->push_task([this, val = std::move(*maybe_value)]() mutable {
+                        this->createAggTask(&val);
+                    }, this->priority());
+                }
             }
 
-            // Move o valor extraído
-            T value = std::move(*maybe_value);
-
-            // Enfileira a tarefa na fila de execução, chamando o método `createAggTask`
-            taskqueue->push_task([this, val = std::move(value)]() mutable {
-                this->createAggTask(&val);
-            });
+            // Espera a entrada acabar e todas as tarefas serem processadas
+            if (!input_buffer -> is_finished() || this->hasRunningTasks()) {
+                return false;
+            }
 
-            // Incrementa o número de 
-            tasksInTaskQueue.notify();
+            // No modo particionado, junta as tabelas parciais das threads
+            if (partitioned) {
+                mergePartitions();
+            }
+            phase = Phase::Merging;
         }
 
-        // Espera até todas as tarefas serem processadas
-        while (tasksInTaskQueue.get_count() > 0) {}
+        if (phase == Phase::Merging) {
+            // Espera até todas as partições serem montadas
+            if (this->hasRunningTasks()) {
+                return false;
+            }
+            if (partitioned) {
+                collectPartitions();
+            }
 
-        // Renomeia a coluna de count (para não ficar igual à de outras tabelas)
-        aggregated.bColumnOperation("count", "count", rename_column, nameCountColumn);
-        aggregated.dropCol("count");
+            // Renomeia a coluna de count (para não ficar igual à de outras tabelas)
+            aggregated.renameCol("count", nameCountColumn);
 
-        // Manda o dataframe pra frente em batches
-        int nRows = aggregated.getShape().first;
-        int batchSize = nRows / 10 + 1;
-        int endRow = 0;
-        int currentRow = 0;
+            // Manda o dataframe pra frente em batches
+            nRows = aggregated.getShape().first;
+            batchSize = nRows / 10 + 1;
+            currentRow = 0;
+            phase = Phase::Sending;
+        }
 
-        while (true)
-        {
-            if (currentRow >= nRows) break;
-            endRow = currentRow + batchSize;
+        // Envia um batch por vez, enquanto houver vaga em todas as saídas
+        while (currentRow < nRows) {
+            if (!this->reserveOutputSlots()) {
+                return false;
+            }
+            int endRow = currentRow + batchSize;
             sendData(currentRow, std::min(endRow, nRows));
             currentRow = endRow;
         }
 
         // Finaliza os buffers de saída após o fim do processamento
         this -> finishBuffer();
+        return true;
     }
 
     // Método abstrato de cálculo das estatísticas
@@ -431,7 +1263,7 @@ public:
     // Método para finalizar os buffers de saída
     void finishBuffer() override {
         for (int i = 0; i < numOutputBuffers; i++) {
-            this -> get_output_buffer_by_index(i).finalizeInput();
+            this -> get_output_buffer_by_index(i).close();
         }
     }
 };
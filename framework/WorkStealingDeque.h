@@ -0,0 +1,146 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Deque de Chase-Lev para roubo de tarefas (work stealing).
+ *
+ * Apenas a thread dona insere e retira pelo fundo (push/pop, em ordem LIFO),
+ * sem locks no caso comum. As demais threads roubam pelo topo (steal, em ordem FIFO)
+ * usando uma única operação compare-and-swap. O vetor circular cresce quando enche;
+ * os vetores antigos são mantidos até a destruição, pois ladrões podem ainda lê-los.
+ *
+ * @tparam T Tipo armazenado (deve ser trivialmente copiável, ex.: ponteiro).
+ */
+template <typename T>
+class WorkStealingDeque
+{
+private:
+    // Vetor circular com capacidade potência de 2
+    struct Array
+    {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> buffer;
+
+        explicit Array(int64_t capacity) : capacity(capacity), buffer(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t i) const { return buffer[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, T value) { buffer[i & (capacity - 1)].store(value, std::memory_order_relaxed); }
+    };
+
+    std::atomic<int64_t> top{0};               // Próxima posição a ser roubada
+    std::atomic<int64_t> bottom{0};            // Próxima posição livre do dono
+    std::atomic<Array *> array;                // Vetor atual
+    std::vector<std::unique_ptr<Array>> arrays; // Todos os vetores já alocados (somente o dono altera)
+
+    // Dobra a capacidade, copiando os elementos entre t e b
+    Array *grow(Array *atual, int64_t b, int64_t t)
+    {
+        arrays.push_back(std::make_unique<Array>(atual->capacity * 2));
+        Array *novo = arrays.back().get();
+        for (int64_t i = t; i < b; i++)
+        {
+            novo->put(i, atual->get(i));
+        }
+        array.store(novo, std::memory_order_release);
+        return novo;
+    }
+
+public:
+    explicit WorkStealingDeque(int64_t capacity = 256)
+    {
+        arrays.push_back(std::make_unique<Array>(capacity));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    /**
+     * Insere um elemento no fundo. Só pode ser chamado pela thread dona.
+     */
+    void push(T value)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array *a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+        {
+            a = grow(a, b, t);
+        }
+        a->put(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Retira um elemento do fundo. Só pode ser chamado pela thread dona.
+     * @return true se conseguiu retirar um elemento.
+     */
+    bool pop(T &out)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // Deque vazio
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = a->get(b);
+        if (t == b)
+        {
+            // Último elemento: disputa com os ladrões
+            bool ganhou = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return ganhou;
+        }
+        return true;
+    }
+
+    /**
+     * Rouba um elemento do topo. Pode ser chamado por qualquer thread.
+     * @return true se conseguiu roubar (false se vazio ou se perdeu a disputa).
+     */
+    bool steal(T &out)
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return false;
+        }
+
+        Array *a = array.load(std::memory_order_acquire);
+        T value = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+
+    /**
+     * Retorna se o deque parece vazio (apenas uma estimativa sob concorrência).
+     */
+    bool empty() const
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b <= t;
+    }
+};
+
+#endif // WORK_STEALING_DEQUE_H
@@ -1,6 +1,10 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
 #include <grpcpp/grpcpp.h>
 #include "mock_client/proto/extractor.pb.h" // Generated by protoc
 #include "mock_client/proto/extractor.grpc.pb.h" // Generated by protoc-gen-grpc
@@ -15,6 +19,16 @@ using extractor::ExtractorService;
 // as they are no longer directly part of AllDataSend in the new proto.
 using extractor::AllDataSend;
 using extractor::AllDataResponse;
+
+// Os campos de estatística do proto são int32: contadores maiores são saturados no limite, com aviso
+static int32_t saturaInt32(int64_t valor, const char* campo) {
+    constexpr int64_t minimo = std::numeric_limits<int32_t>::min();
+    constexpr int64_t maximo = std::numeric_limits<int32_t>::max();
+    if (valor < minimo || valor > maximo) {
+        std::cerr << "Aviso: " << campo << " = " << valor << " não cabe em int32; enviando o valor saturado." << std::endl;
+    }
+    return static_cast<int32_t>(std::clamp(valor, minimo, maximo));
+}
 #include <vector>
 #include <sstream> // Required for std::istringstream
 
@@ -55,16 +69,16 @@ class ExtractorServiceImpl final : public ExtractorService::Service {
 
         
 
-        std::vector<int> stats_response = pipeline(reservas_csv_content,
+        std::vector<int64_t> stats_response = pipeline(reservas_csv_content,
             voos_csv_content,
             pesquisas_csv_content);
             
         // --- Set all stats to 5 as requested ---
-        response->set_stats1(stats_response[0]);
-        response->set_stats2(stats_response[1]);
-        response->set_stats3(stats_response[2]);
-        response->set_stats4(stats_response[3]);
-        response->set_stats5(stats_response[4]);
+        response->set_stats1(saturaInt32(stats_response[0], "stats1"));
+        response->set_stats2(saturaInt32(stats_response[1], "stats2"));
+        response->set_stats3(saturaInt32(stats_response[2], "stats3"));
+        response->set_stats4(saturaInt32(stats_response[3], "stats4"));
+        response->set_stats5(saturaInt32(stats_response[4], "stats5"));
 
         std::cout << "Server sending AllDataResponse with all stats set to 5:" << std::endl;
         std::cout << "  Stats1: " << response->stats1() << std::endl;
@@ -9,27 +9,6 @@
 #include <iostream>
 #include <numeric>
 
-string division(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    if (num2 == 0) {
-        return "Erro: Divisão por zero";
-    }
-    return to_string(num1 / num2);
-}
-
-string multiplication(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    return to_string(num1 * num2);
-}
-
-string minimun(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    return to_string(num1 < num2 ? num1 : num2);
-}
-
 // Classe de filtro do hotel, que filtra os hotéis ocupados
 class FiltroHotel : public Transformer<Dataframe> {
     public:
@@ -68,35 +47,17 @@ class PrecoMedio: public Transformer<Dataframe> {
 
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
-            input[0]->bColumnOperation("preco_sum", "count_reservas", division, "preco_medio");
-            return *input[0];
+            input[0]->withColumn("preco_medio", col("preco_sum") / col("count_reservas"));
+            return std::move(*input[0]);
         }
 };
 
 // Classe do bloco de Join das bases de reservas e pesquisas
-class Join: public Transformer<Dataframe> {
+class Join: public HashJoinTransformer<Dataframe> {
     public:
-        using Transformer::Transformer; // Herda o construtor
-
-        // Definição do método do processamento
-        Dataframe run(std::vector<Dataframe*> input) override {
-            Dataframe df_merged ;
-
-            if ((input[0] -> columns.empty()))
-            {
-                df_merged = *input[0];
-            }
-            else if ((input[1] -> columns.empty()))
-            {
-                df_merged = *input[1];
-            }
-            else{
-                
-                df_merged = input[0]->merge(*input[1], {"cidade_destino", "data_ida_dia", "data_ida_mes"});
-            }
-
-            return df_merged;
-        }
+        // Junta as entradas pelas chaves de cidade e data, mantendo um índice hash de cada lado
+        Join(int num_outputs = 1)
+            : HashJoinTransformer({"cidade_destino", "data_ida_dia", "data_ida_mes"}, num_outputs) {}
 };
 
 // Classe do transformador que calcula a taxa de ocupação dos hotéis
@@ -106,8 +67,8 @@ class TaxaOcupacaoHoteis: public Transformer<Dataframe> {
 
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
-            input[0]->bColumnOperation("count_pesquisas", "quantidade_pessoas_sum", division, "taxa_ocupacao_hoteis");
-            return *input[0];
+            input[0]->withColumn("taxa_ocupacao_hoteis", col("count_pesquisas") / col("quantidade_pessoas_sum"));
+            return std::move(*input[0]);
         }
 };
 
@@ -119,10 +80,10 @@ class Faturamento: public Transformer<Dataframe> {
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
 
-            input[0]->bColumnOperation("count_reservas", "quantidade_pessoas_sum", minimun, "demanda");
-            input[0]->bColumnOperation("preco_medio", "demanda", multiplication, "faturamento_esperado");
+            input[0]->withColumn("demanda", minimo(col("count_reservas"), col("quantidade_pessoas_sum")))
+                     .withColumn("faturamento_esperado", col("preco_medio") * col("demanda"));
 
-            return *input[0];
+            return std::move(*input[0]);
         }
 };
 
@@ -14,27 +14,6 @@ std::vector<Buffer<Dataframe>*> make_input_vector(Buffers&... buffers) {
     return { &buffers... };
 }
 
-string division(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    if (num2 == 0) {
-        return "Erro: Divisão por zero";
-    }
-    return to_string(num1 / num2);
-}
-
-string multiplication(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    return to_string(num1 * num2);
-}
-
-string minimun(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    return to_string(num1 < num2 ? num1 : num2);
-}
-
 class filter_hotel : public Transformer<Dataframe> {
     public:
         using Transformer::Transformer; // Herda o construtor
@@ -74,11 +53,11 @@ class join: public Transformer<Dataframe> {
 
             if ((input[0] -> columns.empty()))
             {
-                df_merged = *input[0];
+                df_merged = std::move(*input[0]);
             }
             else if ((input[1] -> columns.empty()))
             {
-                df_merged = *input[1];
+                df_merged = std::move(*input[1]);
             }
             else{
 
@@ -94,8 +73,8 @@ class PrecoMedio: public Transformer<Dataframe> {
         using Transformer::Transformer; // Herda o construtor
 
         Dataframe run(std::vector<Dataframe*> input) override {
-            input[0]->bColumnOperation("preco_sum", "count_reservas", division, "preco_medio");
-            return *input[0];
+            input[0]->withColumn("preco_medio", col("preco_sum") / col("count_reservas"));
+            return std::move(*input[0]);
         }
 };
 
@@ -105,9 +84,9 @@ class TaxaOcupacao: public Transformer<Dataframe> {
 
         Dataframe run(std::vector<Dataframe*> input) override {
             // std::cout << "Taxa 1" << std::endl;
-            input[0]->bColumnOperation("count_pesquisas", "quantidade_pessoas_sum", division, "taxa_ocupacao");
+            input[0]->withColumn("taxa_ocupacao", col("count_pesquisas") / col("quantidade_pessoas_sum"));
             // std::cout << "Taxa 2" << std::endl;
-            return *input[0];
+            return std::move(*input[0]);
         }
 };
 
@@ -121,10 +100,10 @@ class Faturamento: public Transformer<Dataframe> {
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
 
-            input[0]->bColumnOperation("count_reservas", "quantidade_pessoas_sum", minimun, "demanda");
-            input[0]->bColumnOperation("preco_medio", "demanda", multiplication, "faturamento_esperado");
+            input[0]->withColumn("demanda", minimo(col("count_reservas"), col("quantidade_pessoas_sum")))
+                     .withColumn("faturamento_esperado", col("preco_medio") * col("demanda"));
 
-            return *input[0];
+            return std::move(*input[0]);
         }
 };
 
@@ -145,15 +124,10 @@ class TaxaOcupacaoVoos: public Transformer<Dataframe> {
         
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
-            Dataframe df = *input[0];
+            Dataframe df = std::move(*input[0]);
 
             // Chama o método da própria instância Dataframe
-            df.bColumnOperation(
-                "assentos_ocupados_sum",           // Nome da coluna 1 (numerador)
-                "assentos_totais_sum",             // Nome da coluna 2 (denominador)
-                division,
-                "ocupacao_relativa"            // Nome da nova coluna a ser criada
-            );
+            df.withColumn("ocupacao_relativa", col("assentos_ocupados_sum") / col("assentos_totais_sum"));
 
             return df;
 
@@ -14,59 +14,25 @@ bool PRINT_OUTPUT_DFS = false;
 bool TRIGGERS = false;
 int N_THREADS = 7;
 
-// Função auxiliar para fazer a divisão entre dois valores
-string division(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    if (num2 == 0) {
-        return "Erro: Divisão por zero";
-    }
-    return to_string(num1 / num2);
-}
-
-// Função auxiliar para fazer a multiplicação de dois valores
-string multiplication(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    return to_string(num1 * num2);
-}
-
-// Função auxiliar para retornar o mínimo entre dois valores
-string minimun(string str1, string str2){
-    double num1 = stod(str1);
-    double num2 = stod(str2);
-    return to_string(num1 < num2 ? num1 : num2);
-}
-
 // Classe de filtro do hotel, que filtra os hotéis ocupados
 class FiltroHotel : public Transformer<Dataframe> {
     public:
-        using Transformer::Transformer; // Herda o construtor
-        // Definição do método de cálculo das estatísticas
-        vector<float> calculateStats(std::vector<Dataframe*> input) override {
-            vector<float> calculateStats;
-            Dataframe df_filtred = (*input[0]).filtroByValue("ocupado", 0);
-            float n_vagos = df_filtred.getShape().first;
-            float n_reservados = (*input[0]).getShape().first - n_vagos;
-            calculateStats.push_back(n_vagos);
-            calculateStats.push_back(n_reservados);
-            
-            Dataframe df_filtred_2 = (*input[0]).filtroByValue("cidade_destino", std::string("Rio de Janeiro"));
-            Dataframe df_filtred_3 = (*input[0]).filtroByValue("cidade_destino", std::string("Campo Grande"));
-            float n_rio_janeiro = df_filtred_2.getShape().first;
-            float n_campo_grande = df_filtred_3.getShape().first;
-            calculateStats.push_back(n_rio_janeiro);
-            calculateStats.push_back(n_campo_grande);
-
-
-            return calculateStats;
+        // Declara as estatísticas e o filtro, avaliados pelo framework em uma passada por batch
+        FiltroHotel(int num_outputs = 1) : Transformer(num_outputs) {
+            Predicado vago = Predicado::igual("ocupado", 0);
+            addCounter("vagos", vago);
+            addCounter("reservados", !vago);
+            addCounter("rio_de_janeiro", Predicado::igual("cidade_destino", std::string("Rio de Janeiro")));
+            addCounter("campo_grande", Predicado::igual("cidade_destino", std::string("Campo Grande")));
+            setFilter(vago);
         }
 
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
 
-            Dataframe df_filtred = (*input[0]).filtroByValue("ocupado", 0);
-            return df_filtred;
+            // A entrada já chega com as linhas vagas marcadas (setFilter); a cópia só acontece
+            // se o consumidor não ler a seleção
+            return std::move(*input[0]);
         }
 };
 
@@ -77,35 +43,17 @@ class PrecoMedio: public Transformer<Dataframe> {
 
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
-            input[0]->bColumnOperation("preco_sum", "count_reservas", division, "preco_medio");
-            return *input[0];
+            input[0]->withColumn("preco_medio", col("preco_sum") / col("count_reservas"));
+            return std::move(*input[0]);
         }
 };
 
 // Classe do bloco de Join das bases de reservas e pesquisas
-class Join: public Transformer<Dataframe> {
+class Join: public HashJoinTransformer<Dataframe> {
     public:
-        using Transformer::Transformer; // Herda o construtor
-
-        // Definição do método do processamento
-        Dataframe run(std::vector<Dataframe*> input) override {
-            Dataframe df_merged ;
-
-            if ((input[0] -> columns.empty()))
-            {
-                df_merged = *input[0];
-            }
-            else if ((input[1] -> columns.empty()))
-            {
-                df_merged = *input[1];
-            }
-            else{
-                
-                df_merged = input[0]->merge(*input[1], {"cidade_destino", "data_ida_dia", "data_ida_mes"});
-            }
-
-            return df_merged;
-        }
+        // Junta as entradas pelas chaves de cidade e data, mantendo um índice hash de cada lado
+        Join(int num_outputs = 1)
+            : HashJoinTransformer({"cidade_destino", "data_ida_dia", "data_ida_mes"}, num_outputs) {}
 };
 
 // Classe do transformador que calcula a taxa de ocupação dos hotéis
@@ -115,8 +63,8 @@ class TaxaOcupacaoHoteis: public Transformer<Dataframe> {
 
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
-            input[0]->bColumnOperation("count_pesquisas", "quantidade_pessoas_sum", division, "taxa_ocupacao_hoteis");
-            return *input[0];
+            input[0]->withColumn("taxa_ocupacao_hoteis", col("count_pesquisas") / col("quantidade_pessoas_sum"));
+            return std::move(*input[0]);
         }
 };
 
@@ -128,38 +76,27 @@ class Faturamento: public Transformer<Dataframe> {
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
 
-            input[0]->bColumnOperation("count_reservas", "quantidade_pessoas_sum", minimun, "demanda");
-            input[0]->bColumnOperation("preco_medio", "demanda", multiplication, "faturamento_esperado");
+            input[0]->withColumn("demanda", minimo(col("count_reservas"), col("quantidade_pessoas_sum")))
+                     .withColumn("faturamento_esperado", col("preco_medio") * col("demanda"));
 
-            return *input[0];
+            return std::move(*input[0]);
         }
 };
 
 // Classe do transformador que calcula a taxa de ocupação dos voos
 class TaxaOcupacaoVoos: public Transformer<Dataframe> {
     public:
-        using Transformer::Transformer; // Herda o construtor
-
-        // Definição do método de cálculo das estatísticas
-        vector<float> calculateStats(std::vector<Dataframe*> input) override {
-            vector<float> calculateStats;
-            float n_cidades_diferente = (*input[0]).getShape().first;
-            calculateStats.push_back(n_cidades_diferente);
-
-            return calculateStats;
+        // Declara a estatística: cada linha da entrada agregada é uma cidade destino
+        TaxaOcupacaoVoos(int num_outputs = 1) : Transformer(num_outputs) {
+            addCounter("cidades_destino");
         }
         
         // Definição do método do processamento
         Dataframe run(std::vector<Dataframe*> input) override {
-            Dataframe df = *input[0];
+            Dataframe df = std::move(*input[0]);
 
             // Chama o método da própria instância Dataframe
-            df.bColumnOperation(
-                "assentos_ocupados_sum",           // Nome da coluna 1 (numerador)
-                "assentos_totais_sum",             // Nome da coluna 2 (denominador)
-                division,
-                "ocupacao_relativa"            // Nome da nova coluna a ser criada
-            );
+            df.withColumn("ocupacao_relativa", col("assentos_ocupados_sum") / col("assentos_totais_sum"));
 
             return df;
 
@@ -192,9 +129,9 @@ class DataPrinter : public Loader<Dataframe> {
     };
 
 // Função para executar o pipeline
-vector<int> pipeline(const std::string& dados_reservas,
-                     const std::string& dados_voos,
-                     const std::string& dados_pesquisas) {
+vector<int64_t> pipeline(const std::string& dados_reservas,
+                         const std::string& dados_voos,
+                         const std::string& dados_pesquisas) {
     // Inicializa o Manager
     Manager<Dataframe> manager(N_THREADS);
 
@@ -202,16 +139,26 @@ vector<int> pipeline(const std::string& dados_reservas,
     
     // Inicializa o extrator dos dados de pesquisa e o adiciona ao manager
     Extrator<Dataframe> extrator_pesquisa(dados_pesquisas, "memo", 1000);
+    extrator_pesquisa.setParallelScan(true);
+    extrator_pesquisa.inferSchema();
+    extrator_pesquisa.setDictionaryColumns({"cidade_destino"});
     manager.addExtractor(&extrator_pesquisa);
 
     // Inicializa o extrator dos dados de reserva e o adiciona ao manager
+    // (com o mesmo dicionário das pesquisas, para que o join compare códigos)
     Extrator<Dataframe> extrator_reservas(dados_reservas, "memo", 25000);
+    extrator_reservas.setParallelScan(true);
+    extrator_reservas.inferSchema();
+    extrator_reservas.setDictionaryColumns({"cidade_destino"});
+    extrator_reservas.setStringInterner(extrator_pesquisa.getStringInterner());
     manager.addExtractor(&extrator_reservas);
 
 
     // Inicializa o filtro dos hotéis e o adiciona ao manager
     FiltroHotel filtro_hotel;
     filtro_hotel.addInputBuffer(&extrator_reservas.get_output_buffer());
+    // Colunas lidas pelo filtro (o Manager poda as demais colunas das reservas)
+    filtro_hotel.declareColumns({"ocupado", "cidade_destino"});
     manager.addTransformer(&filtro_hotel);
 
     // Setando os parâmetros do agrupador de reservas
@@ -224,6 +171,7 @@ vector<int> pipeline(const std::string& dados_reservas,
                                                    group,
                                                    vstrColumnsToAggregate,
                                                    ops, "count_reservas");
+    groupby_reservas.setPartitionedAggregation(true);
     manager.addTransformer(&groupby_reservas);
 
     // Inicializa o calculador do preço médio das reservas e o adiciona ao manager
@@ -241,6 +189,7 @@ vector<int> pipeline(const std::string& dados_reservas,
                                                     group,
                                                     vstrColumnsToAggregate,
                                                     ops, "count_pesquisas");
+    groupby_pesquisas.setPartitionedAggregation(true);
     manager.addTransformer(&groupby_pesquisas);
     
     // Inicializa o bloco de Join e o adiciona ao manager
@@ -270,6 +219,9 @@ vector<int> pipeline(const std::string& dados_reservas,
 
     // Inicializa o extrator dos dados de voo e o adiciona ao manager
     Extrator<Dataframe> extrator_voos(dados_voos, "memo", 15000);
+    extrator_voos.setParallelScan(true);
+    extrator_voos.inferSchema();
+    extrator_voos.setDictionaryColumns({"cidade_destino"});
     manager.addExtractor(&extrator_voos);
 
     // Setando os parâmetros do agrupador de voos
@@ -285,6 +237,7 @@ vector<int> pipeline(const std::string& dados_reservas,
         ops,
         "count_voos"
     );
+    groupby_voo.setPartitionedAggregation(true);
     manager.addTransformer(&groupby_voo);
 
     // Inicializa o calculador da taxa de ocupação dos voos e o adiciona ao manager
@@ -305,25 +258,22 @@ vector<int> pipeline(const std::string& dados_reservas,
 
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
     // Printando as estatísticas
-    cout << "Número de quartos ocupados em toda a base: " << filtro_hotel.getStats()[0] << endl;
-    cout << "Número de quartos não ocupados em toda a base: " << filtro_hotel.getStats()[1] << endl;
-    cout << "Número de quartos no Rio de Janeiro: " << filtro_hotel.getStats()[2] << endl;
-    cout << "Número de quartos em Campo Grande: " << filtro_hotel.getStats()[3] << endl;
-    cout << "Número de cidades destino diferentes em toda a base: " << taxa_ocupacao_voos.getStats()[0] << endl;
-
-    vector<float> results = filtro_hotel.getStats();
-    results.push_back(taxa_ocupacao_voos.getStats()[0]);
-
-    std::vector<int> int_results;
-
-    int_results.reserve(results.size());
-    std::transform(results.begin(), results.end(), std::back_inserter(int_results),
-                [](float x) { return static_cast<int>(x); });
+    vector<int64_t> results = {filtro_hotel.getCounter("vagos"),
+                               filtro_hotel.getCounter("reservados"),
+                               filtro_hotel.getCounter("rio_de_janeiro"),
+                               filtro_hotel.getCounter("campo_grande"),
+                               taxa_ocupacao_voos.getCounter("cidades_destino")};
+
+    cout << "Número de quartos ocupados em toda a base: " << results[0] << endl;
+    cout << "Número de quartos não ocupados em toda a base: " << results[1] << endl;
+    cout << "Número de quartos no Rio de Janeiro: " << results[2] << endl;
+    cout << "Número de quartos em Campo Grande: " << results[3] << endl;
+    cout << "Número de cidades destino diferentes em toda a base: " << results[4] << endl;
 
     // cout << "==============================================================================" << endl;
     // std::cout << "Tempo de execução: " << duration << " ms" << std::endl;
     
-    return int_results;
+    return results;
 }
 
 // int main()
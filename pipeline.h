@@ -2,10 +2,12 @@
 #define PIPELINE_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
 
-// Declaração da função pipeline
-std::vector<int> pipeline(const std::string& dados_reservas,
-                          const std::string& dados_voos,
-                          const std::string& dados_pesquisas);
+// Declaração da função pipeline (os contadores são int64, como no registro de métricas)
+std::vector<int64_t> pipeline(const std::string& dados_reservas,
+                              const std::string& dados_voos,
+                              const std::string& dados_pesquisas);
 
 #endif // PIPELINE_H
\ No newline at end of file